@@ -68,10 +68,12 @@ Alias Alias::CreateDistribution(std::vector<double> probabilities, util::Random&
 	return Alias(std::move(alias), std::move(prob), rng);
 }
 
-std::size_t Alias::Next()
+std::size_t Alias::Next() { return Next(*m_random); }
+
+std::size_t Alias::Next(util::Random& rng) const
 {
-	std::size_t roll = (*m_random)(m_alias.size());
-	double flip = m_random->NextDouble();
+	std::size_t roll = rng(m_alias.size());
+	double flip = rng.NextDouble();
 	if (flip <= m_prob[roll]) {
 		return roll;
 	} else {
@@ -33,6 +33,9 @@ public:
 	/// Generates a new number.
 	std::size_t Next();
 
+	/// Generates a new number with the given random number generator instead of this object's.
+	std::size_t Next(util::Random& rng) const;
+
 private:
 	/// Constructor
 	Alias(std::vector<std::size_t>&& alias, std::vector<double>&& prob, util::Random& rng)
@@ -81,6 +84,9 @@ public:
 	/// Generates a new value.
 	T Next() { return value_map[inner_alias.Next()]; }
 
+	/// Generates a new value with the given random number generator instead of this object's.
+	const T& Next(util::Random& rng) const { return value_map[inner_alias.Next(rng)]; }
+
 private:
 	BiasedRandomValueGenerator(Alias&& inner_alias, std::vector<T>&& value_map)
 	    : inner_alias(std::move(inner_alias)), value_map(std::move(value_map))
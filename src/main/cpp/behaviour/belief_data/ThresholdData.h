@@ -21,7 +21,7 @@
 namespace stride {
 
 template <typename BehaviourPolicy, typename BeliefPolicy>
-class GenericPersonData;
+class GenericPerson;
 
 template <bool threshold_infected, bool threshold_adopted>
 class Threshold;
@@ -61,7 +61,7 @@ public:
 	}
 
 	template <typename BehaviourPolicy, typename BeliefPolicy>
-	void Contact(std::shared_ptr<const GenericPersonData<BehaviourPolicy, BeliefPolicy>> p);
+	void Contact(const GenericPerson<BehaviourPolicy, BeliefPolicy>& p);
 
 private:
 	unsigned int m_num_contacts;
@@ -76,11 +76,11 @@ private:
 };
 
 extern template void ThresholdData::Contact<AlwaysFollowBeliefs, Threshold<true, false>>(
-    std::shared_ptr<const GenericPersonData<AlwaysFollowBeliefs, Threshold<true, false>>> p);
+    const GenericPerson<AlwaysFollowBeliefs, Threshold<true, false>>& p);
 extern template void ThresholdData::Contact<AlwaysFollowBeliefs, Threshold<false, true>>(
-    std::shared_ptr<const GenericPersonData<AlwaysFollowBeliefs, Threshold<false, true>>> p);
+    const GenericPerson<AlwaysFollowBeliefs, Threshold<false, true>>& p);
 extern template void ThresholdData::Contact<AlwaysFollowBeliefs, Threshold<true, true>>(
-    std::shared_ptr<const GenericPersonData<AlwaysFollowBeliefs, Threshold<true, true>>> p);
+    const GenericPerson<AlwaysFollowBeliefs, Threshold<true, true>>& p);
 
 } /* namespace stride */
 
@@ -6,7 +6,7 @@
 namespace stride {
 
 template <typename BehaviourPolicy, typename BeliefPolicy>
-class GenericPersonData;
+class GenericPerson;
 
 class NoBelief
 {
@@ -18,7 +18,7 @@ public:
 	static void Update(Data& belief_data, Health& health_data) {}
 
 	template <typename BehaviourPolicy>
-	static void Update(Data& belief_data, std::shared_ptr<const GenericPersonData<BehaviourPolicy, NoBelief>> p)
+	static void Update(Data& belief_data, const GenericPerson<BehaviourPolicy, NoBelief>& p)
 	{
 	}
 
@@ -13,9 +13,9 @@
 
 namespace stride {
 
-/// Forward declaration of class GenericPersonData
+/// Forward declaration of class GenericPerson
 template <typename BehaviourPolicy, typename BeliefPolicy>
-class GenericPersonData;
+class GenericPerson;
 
 template <bool threshold_infected, bool threshold_adopted>
 class Threshold
@@ -37,9 +37,7 @@ public:
 
 	template <typename BehaviourPolicy>
 	static void Update(
-	    Data& belief_data,
-	    std::shared_ptr<const GenericPersonData<BehaviourPolicy, Threshold<threshold_infected, threshold_adopted>>>
-		p)
+	    Data& belief_data, const GenericPerson<BehaviourPolicy, Threshold<threshold_infected, threshold_adopted>>& p)
 	{
 		belief_data.Contact<BehaviourPolicy, Threshold<threshold_infected, threshold_adopted>>(p);
 	}
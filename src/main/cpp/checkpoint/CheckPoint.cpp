@@ -9,6 +9,7 @@
 #include <util/Errors.h>
 #include <util/InstallDirs.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -23,7 +24,178 @@ using namespace std;
 namespace stride {
 namespace checkpoint {
 
-CheckPoint::CheckPoint(const std::string& filename) : m_filename(filename) {}
+namespace {
+
+/// The number of records that are read at once.
+const hsize_t g_block_size = 1U << 14;
+
+/// The (approximate) size in bytes of the chunks in which datasets are stored.
+const std::size_t g_chunk_bytes = 1U << 20;
+
+/// The version of the format of the date groups. Version 1 (which had no version attribute) also stored the
+/// members of every cluster, which are rebuilt from the people instead.
+const unsigned int g_format_version = 2U;
+
+/// Calls f for every record of a one-dimensional dataset, which is read in blocks of g_block_size records
+/// that are converted to the given memory type.
+template <typename T, typename F>
+void ReadBlocks(hid_t dataset, hid_t type, F f)
+{
+	hid_t filespace = H5Dget_space(dataset);
+	hsize_t size;
+	H5Sget_simple_extent_dims(filespace, &size, nullptr);
+
+	std::vector<T> block(std::min(size, g_block_size));
+	for (hsize_t offset = 0; offset < size; offset += g_block_size) {
+		hsize_t count = std::min(size - offset, g_block_size);
+		H5Sselect_hyperslab(filespace, H5S_SELECT_SET, &offset, nullptr, &count, nullptr);
+		hid_t memspace = H5Screate_simple(1, &count, nullptr);
+		H5Dread(dataset, type, memspace, filespace, H5P_DEFAULT, block.data());
+		H5Sclose(memspace);
+		for (hsize_t i = 0; i < count; i++) {
+			f(block[i]);
+		}
+	}
+	H5Sclose(filespace);
+}
+
+/// Reads all records of a one-dimensional dataset, converted to the given memory type.
+template <typename T>
+std::vector<T> ReadAll(hid_t dataset, hid_t type)
+{
+	std::vector<T> result;
+	ReadBlocks<T>(dataset, type, [&result](const T& record) { result.push_back(record); });
+	return result;
+}
+
+/// Attaches a string attribute to the given object.
+void WriteStringAttribute(hid_t location, const char* name, const std::string& value)
+{
+	hsize_t dims = value.size();
+	hid_t dataspace = H5Screate_simple(1, &dims, nullptr);
+	hid_t attr = H5Acreate2(location, name, H5T_NATIVE_CHAR, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+	H5Awrite(attr, H5T_NATIVE_CHAR, value.c_str());
+	H5Aclose(attr);
+	H5Sclose(dataspace);
+}
+
+/// Attaches an unsigned integer attribute to the given object.
+void WriteUIntAttribute(hid_t location, const char* name, unsigned int value)
+{
+	hid_t dataspace = H5Screate(H5S_SCALAR);
+	hid_t attr = H5Acreate2(location, name, H5T_NATIVE_UINT, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+	H5Awrite(attr, H5T_NATIVE_UINT, &value);
+	H5Aclose(attr);
+	H5Sclose(dataspace);
+}
+
+/// Reads an unsigned integer attribute of the given object. Returns false if the object has no such attribute.
+bool ReadUIntAttribute(hid_t location, const char* name, unsigned int& value)
+{
+	if (H5Aexists(location, name) <= 0) {
+		return false;
+	}
+	hid_t attr = H5Aopen(location, name, H5P_DEFAULT);
+	H5Aread(attr, H5T_NATIVE_UINT, &value);
+	H5Aclose(attr);
+	return true;
+}
+
+/// Reads a string attribute of the given object. Returns false if the object has no such attribute.
+bool ReadStringAttribute(hid_t location, const char* name, std::string& value)
+{
+	if (H5Aexists(location, name) <= 0) {
+		return false;
+	}
+	hid_t attr = H5Aopen(location, name, H5P_DEFAULT);
+	H5A_info_t info;
+	H5Aget_info(attr, &info);
+	std::vector<char> data(info.data_size);
+	H5Aread(attr, H5T_NATIVE_CHAR, data.data());
+	H5Aclose(attr);
+	value.assign(data.begin(), data.end());
+	return true;
+}
+
+} // namespace
+
+CheckPoint::CheckPoint(const std::string& filename, unsigned int compression, bool deltas, unsigned int full_interval)
+    : m_filename(filename), m_compression(compression), m_deltas(deltas), m_full_interval(full_interval),
+      m_chain_length(0)
+{
+	if (compression > 9) {
+		FATAL_ERROR("Invalid checkpoint compression level " + std::to_string(compression));
+	}
+	if (deltas && full_interval == 0) {
+		FATAL_ERROR("Invalid interval between full checkpoints 0");
+	}
+}
+
+hid_t CheckPoint::CreateDataSet(
+    hid_t location, const std::string& name, hid_t type, hsize_t size, std::size_t record_size)
+{
+	hid_t dataspace = H5Screate_simple(1, &size, nullptr);
+	hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+	if (size > 0) {
+		hsize_t chunk = std::max<hsize_t>(1, std::min<hsize_t>(size, g_chunk_bytes / record_size));
+		H5Pset_chunk(properties, 1, &chunk);
+		if (m_compression > 0) {
+			H5Pset_shuffle(properties);
+			H5Pset_deflate(properties, m_compression);
+		}
+	}
+	hid_t dataset = H5Dcreate2(location, name.c_str(), type, dataspace, H5P_DEFAULT, properties, H5P_DEFAULT);
+	H5Pclose(properties);
+	H5Sclose(dataspace);
+	return dataset;
+}
+
+hid_t CheckPoint::CreatePersonType()
+{
+	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_personType));
+
+	H5Tinsert(newType, "ID", HOFFSET(h_personType, ID), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Age", HOFFSET(h_personType, Age), H5T_NATIVE_DOUBLE);
+	H5Tinsert(newType, "Gender", HOFFSET(h_personType, Gender), H5T_NATIVE_CHAR);
+	H5Tinsert(newType, "Participating", HOFFSET(h_personType, Participating), H5T_NATIVE_HBOOL);
+	H5Tinsert(newType, "Immune", HOFFSET(h_personType, Immune), H5T_NATIVE_HBOOL);
+	H5Tinsert(newType, "Infected", HOFFSET(h_personType, Infected), H5T_NATIVE_HBOOL);
+	H5Tinsert(newType, "StartInf", HOFFSET(h_personType, StartInf), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "EndInf", HOFFSET(h_personType, EndInf), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "StartSympt", HOFFSET(h_personType, StartSympt), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "EndSympt", HOFFSET(h_personType, EndSympt), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "TimeInfected", HOFFSET(h_personType, TimeInfected), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Status", HOFFSET(h_personType, Status), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Household", HOFFSET(h_personType, Household), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "School", HOFFSET(h_personType, School), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Work", HOFFSET(h_personType, Work), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Primary", HOFFSET(h_personType, Primary), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "Secondary", HOFFSET(h_personType, Secondary), H5T_NATIVE_UINT);
+
+	return newType;
+}
+
+hid_t CheckPoint::CreateVisitorType()
+{
+	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_visitorType));
+
+	H5Tinsert(newType, "DaysLeft", HOFFSET(h_visitorType, DaysLeft), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "RegionID", HOFFSET(h_visitorType, RegionID), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "PersonIDHome", HOFFSET(h_visitorType, PersonIDHome), H5T_NATIVE_UINT);
+	H5Tinsert(newType, "PersonIDVisitor", HOFFSET(h_visitorType, PersonIDVisitor), H5T_NATIVE_UINT);
+
+	return newType;
+}
+
+template <typename T>
+void CheckPoint::WriteDataSet(hid_t location, const std::string& name, hid_t type, const std::vector<T>& records)
+{
+	hid_t dataset = CreateDataSet(location, name, type, records.size(), sizeof(T));
+	if (!records.empty()) {
+		H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, records.data());
+	}
+	H5Dclose(dataset);
+}
 
 void CheckPoint::CreateFile()
 {
@@ -136,63 +308,6 @@ void CheckPoint::WriteHolidays(const std::string& filename)
 	WriteFileDSet(filename, "holidays");
 }
 
-void CheckPoint::WritePopulation(const Population& pop, boost::gregorian::date date)
-{
-	std::string datestr = to_iso_string(date);
-	htri_t exist = H5Lexists(m_file, datestr.c_str(), H5P_DEFAULT);
-	if (exist <= 0) {
-		hid_t temp = H5Gcreate2(m_file, datestr.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-		H5Gclose(temp);
-	}
-
-	hsize_t dims[1] = {pop.size()};
-	hid_t dataspace = H5Screate_simple(1, dims, nullptr);
-	std::string spot = datestr + "/Population";
-
-	hid_t chunkP = H5Pcreate(H5P_DATASET_CREATE);
-	hsize_t chunkDims[1] = {1};
-	H5Pset_chunk(chunkP, 1, chunkDims);
-
-	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_personType));
-
-	H5Tinsert(newType, "ID", HOFFSET(h_personType, ID), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Age", HOFFSET(h_personType, Age), H5T_NATIVE_DOUBLE);
-	H5Tinsert(newType, "Gender", HOFFSET(h_personType, Gender), H5T_NATIVE_CHAR);
-	H5Tinsert(newType, "Participating", HOFFSET(h_personType, Participating), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "Immune", HOFFSET(h_personType, Immune), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "Infected", HOFFSET(h_personType, Infected), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "StartInf", HOFFSET(h_personType, StartInf), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "EndInf", HOFFSET(h_personType, EndInf), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "StartSympt", HOFFSET(h_personType, StartSympt), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "EndSympt", HOFFSET(h_personType, EndSympt), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "TimeInfected", HOFFSET(h_personType, TimeInfected), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Household", HOFFSET(h_personType, Household), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "School", HOFFSET(h_personType, School), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Work", HOFFSET(h_personType, Work), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Primary", HOFFSET(h_personType, Primary), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Secondary", HOFFSET(h_personType, Secondary), H5T_NATIVE_UINT);
-
-	hid_t dataset = H5Dcreate2(m_file, spot.c_str(), newType, dataspace, H5P_DEFAULT, chunkP, H5P_DEFAULT);
-
-	chunkP = H5Pcreate(H5P_DATASET_XFER);
-	unsigned int i = 0;
-
-	pop.serial_for([this, &i, &newType, &dataspace, &dataset, &chunkP](const Person& p, unsigned int) {
-		h_personType data(p);
-
-		hsize_t start[1] = {i};
-		hsize_t count[1] = {1};
-		hid_t chunkspace = H5Screate_simple(1, count, nullptr);
-		H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
-		H5Dwrite(dataset, newType, chunkspace, dataspace, chunkP, &data);
-		i++;
-		H5Sclose(chunkspace);
-	});
-	H5Tclose(newType);
-	H5Dclose(dataset);
-	H5Sclose(dataspace);
-}
-
 void CheckPoint::WriteFileDSet(const std::string& filename, const std::string& setname)
 {
 	boost::filesystem::path path = util::InstallDirs::GetDataDir();
@@ -317,15 +432,109 @@ std::string CheckPoint::WriteDSetFile(const std::string& filestr, const std::str
 	return filename.string();
 }
 
-void CheckPoint::SaveCheckPoint(const Simulator& sim, std::size_t day)
+void CheckPoint::SaveCheckPoint(const Simulator& sim, std::size_t day) { WriteSnapshot(TakeSnapshot(sim, day)); }
+
+CheckPoint::Snapshot CheckPoint::TakeSnapshot(const Simulator& sim, std::size_t day)
 {
 	// TODO: add airport
-	WritePopulation(*sim.GetPopulation(), sim.GetDate());
-	WriteClusters(sim.GetClusters(), sim.GetDate());
-	auto exp = sim.GetExpatriateJournal();
-	WriteExpatriates(exp, sim.GetDate());
-	auto vis = sim.GetVistiorJournal();
-	WriteVisitors(vis, sim.GetDate(), day);
+	Snapshot snapshot;
+	snapshot.date = sim.GetDate();
+
+	const auto& pop = *sim.GetPopulation();
+	snapshot.population.reserve(pop.size());
+	pop.serial_for([&snapshot, &sim](const Person& p, unsigned int) {
+		snapshot.population.emplace_back(p);
+		snapshot.population.back().TimeInfected = sim.GetDaysInfected(p);
+	});
+
+	sim.GetExpatriateJournal().SerialForeach(
+	    [&snapshot](const Person& p, unsigned int) { snapshot.expatriates.emplace_back(p); });
+
+	const auto& visitors = sim.GetVistiorJournal();
+	snapshot.visitors.reserve(visitors.GetVisitorCount());
+	for (auto& days : visitors.GetVisitors()) {
+		for (auto& place : days.second) {
+			for (auto p : place.second) {
+				h_visitorType i;
+				i.DaysLeft = days.first - day;
+				i.RegionID = place.first;
+				i.PersonIDHome = p.home_id;
+				i.PersonIDVisitor = p.visitor_id;
+				snapshot.visitors.push_back(i);
+			}
+		}
+	}
+	return snapshot;
+}
+
+void CheckPoint::WriteSnapshot(Snapshot snapshot)
+{
+	std::string datestr = to_iso_string(snapshot.date);
+	htri_t exist = H5Lexists(m_file, datestr.c_str(), H5P_DEFAULT);
+	if (exist <= 0) {
+		hid_t temp = H5Gcreate2(m_file, datestr.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+		H5Gclose(temp);
+	}
+	hid_t group = H5Gopen2(m_file, datestr.c_str(), H5P_DEFAULT);
+	WriteUIntAttribute(group, "version", g_format_version);
+
+	// The clusters aren't stored: every person knows their clusters, so they are rebuilt on load.
+	hid_t personType = CreatePersonType();
+	if (m_previous) {
+		WriteDelta(group, snapshot, *m_previous);
+		m_chain_length++;
+	} else {
+		WriteDataSet(group, "Population", personType, snapshot.population);
+		m_chain_length = 0;
+	}
+
+	// The journals are small, so they are always stored in full.
+	WriteDataSet(group, "Expatriates", personType, snapshot.expatriates);
+	H5Tclose(personType);
+
+	hid_t visitorType = CreateVisitorType();
+	WriteDataSet(group, "Visitors", visitorType, snapshot.visitors);
+	H5Tclose(visitorType);
+
+	H5Gclose(group);
+
+	// Only keep the people around if the next checkpoint needs them, so that a full checkpoint also frees the
+	// memory of the chain before it. Bounding the chain keeps loading a date cheap.
+	if (m_deltas && m_chain_length + 1 < m_full_interval) {
+		m_previous = std::make_unique<Snapshot>(std::move(snapshot));
+	} else {
+		m_previous.reset();
+	}
+}
+
+void CheckPoint::WriteDelta(hid_t group, const Snapshot& snapshot, const Snapshot& previous)
+{
+	WriteStringAttribute(group, "previous", to_iso_string(previous.date));
+
+	// Both populations are ordered by id, so they can be compared in a single pass.
+	std::vector<h_personType> changed;
+	std::vector<unsigned int> removed;
+	auto current = snapshot.population.begin();
+	auto old = previous.population.begin();
+	while (current != snapshot.population.end() || old != previous.population.end()) {
+		if (old == previous.population.end() ||
+		    (current != snapshot.population.end() && current->ID < old->ID)) {
+			changed.push_back(*current++);
+		} else if (current == snapshot.population.end() || old->ID < current->ID) {
+			removed.push_back(old++->ID);
+		} else {
+			if (!(*current == *old)) {
+				changed.push_back(*current);
+			}
+			++current;
+			++old;
+		}
+	}
+
+	hid_t personType = CreatePersonType();
+	WriteDataSet(group, "Population", personType, changed);
+	H5Tclose(personType);
+	WriteDataSet(group, "Removed", H5T_NATIVE_UINT, removed);
 }
 
 void CheckPoint::CombineCheckPoint(unsigned int groupnum, const std::string& filename)
@@ -363,47 +572,46 @@ void CheckPoint::LoadCheckPoint(boost::gregorian::date date, Simulator& sim)
 {
 
 	std::string groupname = to_iso_string(date);
-	std::string name = groupname + "/Population";
-	htri_t exist = H5Lexists(m_file, name.c_str(), H5P_DEFAULT);
-	if (exist <= 0) {
-		FATAL_ERROR("Incorrect date loaded");
-	}
-	// loading people
-	hid_t dset = H5Dopen(m_file, name.c_str(), H5P_DEFAULT);
-	hid_t dspace = H5Dget_space(dset);
-	hid_t newType = H5Dget_type(dset);
-
-	hsize_t dims;
-	H5Sget_simple_extent_dims(dspace, &dims, nullptr);
+	const auto people = LoadPeople(groupname);
 
 	auto result = make_shared<Population>();
+	result->reserve(people.size());
 
-	for (hsize_t i = 0; i < dims; i++) {
-		hsize_t start = i;
-
-		hsize_t count = 1;
-
-		hid_t subspace = H5Screate_simple(1, &count, nullptr);
+	for (const auto& data : people) {
+		RestorePerson(*result, data);
+	}
 
-		H5Sselect_hyperslab(dspace, H5S_SELECT_SET, &start, nullptr, &count, nullptr);
+	LoadAtlas(*result);
 
-		h_personType data;
+	sim.SetPopulation(result);
+	sim.SetExpatriates(LoadExpatriates(*result, date));
+	// People's health was set after they were added to the population, so count it again.
+	result->count_health();
+	sim.SetVisitors(LoadVisitors(date));
 
-		H5Dread(dset, newType, subspace, dspace, H5P_DEFAULT, &data);
+	// Every person knows their clusters, so the clusters are rebuilt rather than stored.
+	sim.InitializeClusters();
+}
 
-		disease::Fate disease;
-		disease.start_infectiousness = data.StartInf;
-		disease.start_symptomatic = data.StartSympt;
-		disease.end_infectiousness = data.EndInf;
-		disease.end_symptomatic = data.EndSympt;
+Person CheckPoint::RestorePerson(Population& pop, const h_personType& data)
+{
+	disease::Fate disease;
+	disease.start_infectiousness = data.StartInf;
+	disease.start_symptomatic = data.StartSympt;
+	disease.end_infectiousness = data.EndInf;
+	disease.end_symptomatic = data.EndSympt;
 
-		Person toAdd(
-		    data.ID, data.Age, data.Household, data.School, data.Work, data.Primary, data.Secondary, disease);
+	Person toAdd = pop.emplace(
+	    data.ID, data.Age, data.Household, data.School, data.Work, data.Primary, data.Secondary, disease);
 
-		if (data.Participating) {
-			toAdd.ParticipateInSurvey();
-		}
+	if (data.Participating) {
+		toAdd.ParticipateInSurvey();
+	}
 
+	if (data.Status < NumOfHealthStatuses()) {
+		toAdd.GetHealth() = Health(disease, static_cast<HealthStatus>(data.Status), data.TimeInfected);
+	} else {
+		// Older checkpoints don't store the status, so replay the disease to recover it.
 		if (data.Immune) {
 			toAdd.GetHealth().SetImmune();
 		}
@@ -413,87 +621,79 @@ void CheckPoint::LoadCheckPoint(boost::gregorian::date date, Simulator& sim)
 		for (unsigned int i = 0; i < data.TimeInfected; i++) {
 			toAdd.GetHealth().Update();
 		}
-
-		result->emplace(toAdd);
-		H5Sclose(subspace);
 	}
-
-	H5Sclose(dspace);
-	H5Tclose(newType);
-	H5Dclose(dset);
-
-	LoadAtlas(*result);
-
-	sim.SetPopulation(result);
-	sim.SetExpatriates(LoadExpatriates(*result, date));
-	sim.SetVisitors(LoadVisitors(date));
-
-	ClusterStruct clusters;
-	// loading clusters
-	LoadCluster(sim.GetClusters().m_households, ClusterType::Household, groupname, *result);
-	LoadCluster(sim.GetClusters().m_school_clusters, ClusterType::School, groupname, *result);
-	LoadCluster(sim.GetClusters().m_work_clusters, ClusterType::Work, groupname, *result);
-	LoadCluster(sim.GetClusters().m_primary_community, ClusterType::PrimaryCommunity, groupname, *result);
-	LoadCluster(sim.GetClusters().m_secondary_community, ClusterType::SecondaryCommunity, groupname, *result);
+	return toAdd;
 }
 
-void CheckPoint::LoadCluster(
-    std::vector<Cluster>& clusters, const ClusterType& i, const std::string& groupname, const Population& result)
+std::vector<CheckPoint::h_personType> CheckPoint::LoadPeople(const std::string& groupname)
 {
-	clusters.clear();
-	std::string type = ToString(i);
-	std::string path = groupname + "/" + type;
-	hid_t clusterID = H5Dopen2(m_file, path.c_str(), H5P_DEFAULT);
-	hid_t dspace = H5Dget_space(clusterID);
-	hid_t newType = H5Dget_type(clusterID);
-
-	hsize_t dims;
-	H5Sget_simple_extent_dims(dspace, &dims, nullptr);
-
-	hsize_t start = 0;
-
-	hsize_t count = 1;
-
-	hid_t subspace = H5Dget_space(clusterID);
-	H5Sselect_hyperslab(subspace, H5S_SELECT_SET, &start, nullptr, &count, nullptr);
-
-	h_clusterType data;
-
-	H5Dread(clusterID, newType, H5S_ALL, subspace, H5P_DEFAULT, &data);
-
-	H5Sclose(subspace);
-
-	std::unique_ptr<Cluster> CurrentCluster = std::make_unique<Cluster>(data.ID, i);
-
-	for (hsize_t j = 1; j < dims; j++) {
-		hsize_t start = j;
-		hsize_t count = 1;
-
-		hid_t subspace = H5Screate_simple(1, &count, nullptr);
-
-		H5Sselect_hyperslab(dspace, H5S_SELECT_SET, &start, nullptr, &count, nullptr);
-
-		h_clusterType data;
+	// Follow the chain of deltas back to the last full checkpoint.
+	std::vector<std::string> chain{groupname};
+	while (true) {
+		const std::string& name = chain.back();
+		htri_t exist = H5Lexists(m_file, name.c_str(), H5P_DEFAULT);
+		if (exist <= 0 || H5Lexists(m_file, (name + "/Population").c_str(), H5P_DEFAULT) <= 0) {
+			FATAL_ERROR("Incorrect date loaded");
+		}
+		hid_t group = H5Gopen2(m_file, name.c_str(), H5P_DEFAULT);
+		unsigned int version = 1U;
+		ReadUIntAttribute(group, "version", version);
+		if (version > g_format_version) {
+			H5Gclose(group);
+			FATAL_ERROR("Checkpoint " + name + " has format version " + std::to_string(version) +
+				    ", which is newer than version " + std::to_string(g_format_version));
+		}
+		std::string previous;
+		const bool isDelta = ReadStringAttribute(group, "previous", previous);
+		H5Gclose(group);
+		if (!isDelta) {
+			break;
+		}
+		if (std::find(chain.begin(), chain.end(), previous) != chain.end()) {
+			FATAL_ERROR("The deltas of checkpoint " + groupname + " form a cycle");
+		}
+		chain.push_back(previous);
+	}
 
-		H5Dread(clusterID, newType, subspace, dspace, H5P_DEFAULT, &data);
+	hid_t personType = CreatePersonType();
+	hid_t dset = H5Dopen2(m_file, (chain.back() + "/Population").c_str(), H5P_DEFAULT);
+	auto result = ReadAll<h_personType>(dset, personType);
+	H5Dclose(dset);
 
-		H5Sclose(subspace);
+	// Apply the deltas from the oldest to the newest. Their changes, like the people of a full checkpoint, are
+	// ordered by id.
+	for (auto name = chain.rbegin() + 1; name != chain.rend(); ++name) {
+		hid_t group = H5Gopen2(m_file, name->c_str(), H5P_DEFAULT);
+		dset = H5Dopen2(group, "Population", H5P_DEFAULT);
+		const auto people = ReadAll<h_personType>(dset, personType);
+		H5Dclose(dset);
+		dset = H5Dopen2(group, "Removed", H5P_DEFAULT);
+		const auto removed = ReadAll<unsigned int>(dset, H5T_NATIVE_UINT);
+		H5Dclose(dset);
+		H5Gclose(group);
 
-		if (data.ID != CurrentCluster->GetId()) {
-			clusters.emplace_back(*CurrentCluster);
-			CurrentCluster = std::make_unique<Cluster>(data.ID, i);
-			continue;
+		std::vector<h_personType> next;
+		next.reserve(result.size() + people.size());
+		auto changed = people.begin();
+		auto gone = removed.begin();
+		for (const auto& person : result) {
+			while (changed != people.end() && changed->ID < person.ID) {
+				next.push_back(*changed++);
+			}
+			while (gone != removed.end() && *gone < person.ID) {
+				++gone;
+			}
+			if (changed != people.end() && changed->ID == person.ID) {
+				next.push_back(*changed++);
+			} else if (gone == removed.end() || *gone != person.ID) {
+				next.push_back(person);
+			}
 		}
-
-		unsigned int idPersonToAdd = data.PersonID;
-
-		CurrentCluster->AddPerson(result.getPerson(idPersonToAdd));
+		next.insert(next.end(), changed, people.end());
+		result = std::move(next);
 	}
-
-	clusters.emplace_back(*CurrentCluster);
-	H5Tclose(newType);
-	H5Dclose(clusterID);
-	H5Sclose(dspace);
+	H5Tclose(personType);
+	return result;
 }
 
 MultiSimulationConfig CheckPoint::LoadMultiConfig()
@@ -660,174 +860,7 @@ Calendar CheckPoint::LoadCalendar(boost::gregorian::date date)
 	return result;
 }
 
-void CheckPoint::WriteClusters(const ClusterStruct& clusters, boost::gregorian::date date)
-{
-
-	std::string datestr = to_iso_string(date);
-	htri_t exist = H5Lexists(m_file, datestr.c_str(), H5P_DEFAULT);
-	if (exist <= 0) {
-		hid_t temp = H5Gcreate2(m_file, datestr.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-		H5Gclose(temp);
-	}
-	hid_t group = H5Gopen2(m_file, datestr.c_str(), H5P_DEFAULT);
-
-	WriteCluster(clusters.m_households, group, ClusterType::Household);
-	WriteCluster(clusters.m_school_clusters, group, ClusterType::School);
-	WriteCluster(clusters.m_work_clusters, group, ClusterType::Work);
-	WriteCluster(clusters.m_primary_community, group, ClusterType::PrimaryCommunity);
-	WriteCluster(clusters.m_secondary_community, group, ClusterType::SecondaryCommunity);
-
-	H5Gclose(group);
-}
-
-void CheckPoint::WriteCluster(const std::vector<Cluster>& clvector, hid_t& group, const ClusterType& t)
-{
-	std::string dsetname = ToString(t);
-
-	unsigned int totalSize = 0;
-	std::vector<unsigned int> sizes;
-
-	for (auto& cluster : clvector) {
-		totalSize += cluster.GetSize() + 1;
-		sizes.push_back(cluster.GetSize());
-	}
-	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_clusterType));
-
-	H5Tinsert(newType, "ID", HOFFSET(h_clusterType, ID), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "PersonID", HOFFSET(h_clusterType, PersonID), H5T_NATIVE_UINT);
-
-	hsize_t dims = totalSize;
-	hid_t dataspace = H5Screate_simple(1, &dims, nullptr);
-
-	hid_t dataset = H5Dcreate2(group, dsetname.c_str(), newType, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-	unsigned int spot = 0;
-	for (auto& cluster : clvector) {
-		auto people = cluster.GetPeople();
-
-		std::vector<h_clusterType> data{cluster.GetSize() + 1};
-
-		// Start of new cluster
-		data[0].ID = cluster.GetId();
-		data[0].PersonID = 0;
-		// Data in cluster
-		for (unsigned int i = 1; i <= people.size(); i++) {
-			data[i].ID = cluster.GetId();
-			data[i].PersonID = people[i - 1].GetId();
-		}
-
-		hsize_t start = spot;
-		hsize_t count = cluster.GetSize() + 1;
-		hid_t chunkspace = H5Screate_simple(1, &count, nullptr);
-		H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, &start, nullptr, &count, nullptr);
-
-		hid_t plist = H5Pcreate(H5P_DATASET_XFER);
-
-		H5Dwrite(dataset, newType, chunkspace, dataspace, plist, data.data());
-		spot += cluster.GetSize() + 1;
-		H5Sclose(chunkspace);
-		H5Pclose(plist);
-	}
-	H5Tclose(newType);
-	H5Sclose(dataspace);
-	H5Dclose(dataset);
-}
-
-void CheckPoint::WriteExpatriates(multiregion::ExpatriateJournal& journal, boost::gregorian::date date)
-{
-	std::string datestr = to_iso_string(date);
-	htri_t exist = H5Lexists(m_file, datestr.c_str(), H5P_DEFAULT);
-	if (exist <= 0) {
-		hid_t temp = H5Gcreate2(m_file, datestr.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-		H5Gclose(temp);
-	}
-	hid_t group = H5Gopen2(m_file, datestr.c_str(), H5P_DEFAULT);
-
-	std::string dsetname = "Expatriates";
-
-	std::vector<h_personType> data;
-
-	journal.SerialForeach([&data](const Person& p, unsigned int) {
-		h_personType tempPerson(p);
-		data.push_back(tempPerson);
-	});
-
-	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_personType));
-
-	H5Tinsert(newType, "ID", HOFFSET(h_personType, ID), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Age", HOFFSET(h_personType, Age), H5T_NATIVE_DOUBLE);
-	H5Tinsert(newType, "Gender", HOFFSET(h_personType, Gender), H5T_NATIVE_CHAR);
-	H5Tinsert(newType, "Participating", HOFFSET(h_personType, Participating), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "Immune", HOFFSET(h_personType, Immune), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "Infected", HOFFSET(h_personType, Infected), H5T_NATIVE_HBOOL);
-	H5Tinsert(newType, "StartInf", HOFFSET(h_personType, StartInf), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "EndInf", HOFFSET(h_personType, EndInf), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "StartSympt", HOFFSET(h_personType, StartSympt), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "EndSympt", HOFFSET(h_personType, EndSympt), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "TimeInfected", HOFFSET(h_personType, TimeInfected), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Household", HOFFSET(h_personType, Household), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "School", HOFFSET(h_personType, School), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Work", HOFFSET(h_personType, Work), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Primary", HOFFSET(h_personType, Primary), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "Secondary", HOFFSET(h_personType, Secondary), H5T_NATIVE_UINT);
-
-	hsize_t dims = data.size();
-	hid_t dataspace = H5Screate_simple(1, &dims, nullptr);
-
-	hid_t dataset = H5Dcreate2(group, dsetname.c_str(), newType, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-	H5Dwrite(dataset, newType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
-
-	H5Sclose(dataspace);
-	H5Dclose(dataset);
-	H5Gclose(group);
-}
-
-void CheckPoint::WriteVisitors(multiregion::VisitorJournal& journal, boost::gregorian::date date, std::size_t day)
-{
-	std::string datestr = to_iso_string(date);
-	htri_t exist = H5Lexists(m_file, datestr.c_str(), H5P_DEFAULT);
-	if (exist <= 0) {
-		hid_t temp = H5Gcreate2(m_file, datestr.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-		H5Gclose(temp);
-	}
-	hid_t group = H5Gopen2(m_file, datestr.c_str(), H5P_DEFAULT);
-
-	std::string dsetname = "Visitors";
-
-	std::vector<h_visitorType> data(journal.GetVisitorCount());
-
-	for (auto& days : journal.GetVisitors()) {
-		for (auto& place : days.second) {
-			for (auto p : place.second) {
-				h_visitorType i;
-				i.DaysLeft = days.first - day;
-				i.RegionID = place.first;
-				i.PersonIDHome = p.home_id;
-				i.PersonIDVisitor = p.visitor_id;
-				data.push_back(i);
-			}
-		}
-	}
-
-	hid_t newType = H5Tcreate(H5T_COMPOUND, sizeof(h_visitorType));
-
-	H5Tinsert(newType, "DaysLeft", HOFFSET(h_visitorType, DaysLeft), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "RegionID", HOFFSET(h_visitorType, RegionID), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "PersonIDHome", HOFFSET(h_visitorType, PersonIDHome), H5T_NATIVE_UINT);
-	H5Tinsert(newType, "PersonIDVisitor", HOFFSET(h_visitorType, PersonIDVisitor), H5T_NATIVE_UINT);
-
-	hsize_t dims = data.size();
-	hid_t dataspace = H5Screate_simple(1, &dims, nullptr);
-
-	hid_t dataset = H5Dcreate2(group, dsetname.c_str(), newType, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-	H5Dwrite(dataset, newType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
-
-	H5Tclose(newType);
-	H5Sclose(dataspace);
-	H5Dclose(dataset);
-	H5Gclose(group);
-}
-
-multiregion::ExpatriateJournal CheckPoint::LoadExpatriates(const Population& pop, boost::gregorian::date date)
+multiregion::ExpatriateJournal CheckPoint::LoadExpatriates(Population& pop, boost::gregorian::date date)
 {
 	multiregion::ExpatriateJournal result;
 	std::string dsetName = to_iso_string(date) + "/Expatriates";
@@ -842,7 +875,7 @@ multiregion::ExpatriateJournal CheckPoint::LoadExpatriates(const Population& pop
 	hsize_t dims;
 	H5Sget_simple_extent_dims(dspace, &dims, nullptr);
 
-	hid_t newType = H5Dget_type(dset);
+	hid_t newType = CreatePersonType();
 
 	std::vector<h_personType> data(dims);
 
@@ -853,29 +886,8 @@ multiregion::ExpatriateJournal CheckPoint::LoadExpatriates(const Population& pop
 	H5Tclose(newType);
 
 	for (auto& p : data) {
-
-		disease::Fate disease;
-		disease.start_infectiousness = p.StartInf;
-		disease.start_symptomatic = p.StartSympt;
-		disease.end_infectiousness = p.EndInf;
-		disease.end_symptomatic = p.EndSympt;
-
-		Person toAdd(p.ID, p.Age, p.Household, p.School, p.Work, p.Primary, p.Secondary, disease);
-
-		if (p.Participating) {
-			toAdd.ParticipateInSurvey();
-		}
-
-		if (p.Immune) {
-			toAdd.GetHealth().SetImmune();
-		}
-		if (p.Infected) {
-			toAdd.GetHealth().StartInfection();
-		}
-		for (unsigned int i = 0; i < p.TimeInfected; i++) {
-			toAdd.GetHealth().Update();
-		}
-		result.AddExpatriate(toAdd);
+		Person toAdd = RestorePerson(pop, p);
+		result.AddExpatriate(pop.detach(toAdd.GetId()));
 	}
 	return result;
 }
@@ -925,6 +937,7 @@ void CheckPoint::WriteAtlas(const Atlas& atlas)
 	}
 
 	std::vector<h_clusterAtlas> data;
+	data.reserve(atlas.cluster_map.size());
 	for (auto& i : atlas.cluster_map) {
 		h_clusterAtlas info;
 		info.ClusterID = i.first.first;
@@ -943,14 +956,10 @@ void CheckPoint::WriteAtlas(const Atlas& atlas)
 	H5Tinsert(newType, "Latitude", HOFFSET(h_clusterAtlas, latitude), H5T_NATIVE_DOUBLE);
 	H5Tinsert(newType, "Longitude", HOFFSET(h_clusterAtlas, longitude), H5T_NATIVE_DOUBLE);
 
-	hsize_t dims = data.size();
-	hid_t dataspace = H5Screate_simple(1, &dims, nullptr);
-
-	hid_t dataset = H5Dcreate2(m_file, "Config/Atlas", newType, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	hid_t dataset = CreateDataSet(m_file, "Config/Atlas", newType, data.size(), sizeof(h_clusterAtlas));
 	H5Dwrite(dataset, newType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
 
 	H5Tclose(newType);
-	H5Sclose(dataspace);
 	H5Dclose(dataset);
 
 	WriteTowns(atlas);
@@ -2,6 +2,7 @@
 #define CHECKPOINT_H_INCLUDED
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include <hdf5.h>
 #include "calendar/Calendar.h"
@@ -18,8 +19,13 @@ namespace checkpoint {
 class CheckPoint
 {
 public:
-	/// Constructor The string is the file for the checkpoints.
-	CheckPoint(const std::string& filename);
+	/// Constructor The string is the file for the checkpoints. Datasets that are written are compressed with
+	/// the given deflate level (0 to 9), where 0 means that they are not compressed. If deltas is true, the
+	/// checkpoints that this object writes only store what changed since the previous one, except for every
+	/// full_interval-th one (starting with the first), which is stored in full.
+	CheckPoint(
+	    const std::string& filename, unsigned int compression = 0, bool deltas = false,
+	    unsigned int full_interval = 10);
 
 	/// Creates the wanted file and immediately closes it. It will overwrite a file if one of the same name already
 	/// exists.
@@ -47,6 +53,19 @@ public:
 	/// The first parameter is the Simulator you save from, the second parameter is the day in the simulation.
 	void SaveCheckPoint(const Simulator& simulation, std::size_t day);
 
+	/// The records that SaveCheckPoint writes for one date, copied from a simulator.
+	struct Snapshot;
+
+	/// Copies the state of the simulator on the given day into a snapshot. This is much cheaper than writing
+	/// it, and the snapshot can be written (by another thread) while the simulator continues.
+	static Snapshot TakeSnapshot(const Simulator& simulation, std::size_t day);
+
+	/// Writes a snapshot to the checkpoint, as SaveCheckPoint would have written it. In delta mode, only the
+	/// people that changed since the previously written snapshot are stored (unless it is time for a full
+	/// one), and the date group refers to the group of that snapshot in its "previous" attribute. The date
+	/// group's "version" attribute holds the format version.
+	void WriteSnapshot(Snapshot snapshot);
+
 	/// Copies the info in the filename under the data of the given simulation.
 	/// The first parameter is the ID of the simulation you want to save, the second parameter is the name of the
 	/// file subcheckpoint.
@@ -104,28 +123,15 @@ public:
 	void StoreConfig(const std::string& filename);
 
 private:
-	/// Writes the current population to a checkpoint.
-	void WritePopulation(const Population& pop, boost::gregorian::date date);
-
-	/// Writes the clusters to a checkpoint.
-	void WriteClusters(const ClusterStruct& clusters, boost::gregorian::date date);
-
-	/// Writes the visitors to a checkpoint.
-	void WriteVisitors(multiregion::VisitorJournal& visitors, boost::gregorian::date date, std::size_t day);
-
-	/// Writes the expatriates to a checkpoint.
-	void WriteExpatriates(multiregion::ExpatriateJournal& expatriates, boost::gregorian::date date);
-
-	/// Loads one type Cluster
-	void WriteCluster(const std::vector<Cluster>& clusters, hid_t& group, const ClusterType& type);
+	/// Writes the given records to a new one-dimensional dataset.
+	template <typename T>
+	void WriteDataSet(hid_t location, const std::string& name, hid_t type, const std::vector<T>& records);
 
-	/// Loads one type Cluster
-	void LoadCluster(
-	    std::vector<Cluster>& clusters, const ClusterType& type, const std::string& groupname,
-	    const Population& pop);
+	/// Writes the people of the snapshot that changed since the previous snapshot.
+	void WriteDelta(hid_t group, const Snapshot& snapshot, const Snapshot& previous);
 
 	/// Loads the Expatriate journal
-	multiregion::ExpatriateJournal LoadExpatriates(const Population& pop, boost::gregorian::date date);
+	multiregion::ExpatriateJournal LoadExpatriates(Population& pop, boost::gregorian::date date);
 
 	/// Loads the Visitor journal
 	multiregion::VisitorJournal LoadVisitors(boost::gregorian::date date);
@@ -152,11 +158,25 @@ private:
 	/// Writes the towns from the Atlas
 	void WriteTowns(const Atlas& atlas);
 
+	/// Creates a one-dimensional dataset with the given number of records. The dataset is chunked
+	/// (and compressed, if compression is enabled) unless it is empty.
+	hid_t CreateDataSet(hid_t location, const std::string& name, hid_t type, hsize_t size, std::size_t record_size);
+
+	/// Creates the compound type of the person records.
+	static hid_t CreatePersonType();
+
+	/// Creates the compound type of the visitor records.
+	static hid_t CreateVisitorType();
+
 	/// Loads the towns into the Atlas
 	void LoadTowns(Population& pop);
 
 	hid_t m_file;		      //< current hdf5 workspace
 	const std::string m_filename; //< filename
+	unsigned int m_compression;   //< deflate level of the datasets that are written
+	bool m_deltas;		      //< whether checkpoints are written as deltas
+	unsigned int m_full_interval; //< in delta mode, the number of checkpoints from one full one to the next
+	unsigned int m_chain_length;  //< the number of checkpoints written since the last full one
 
 	struct h_personType
 	{
@@ -173,6 +193,7 @@ private:
 		unsigned int StartSympt;
 		unsigned int EndSympt;
 		unsigned int TimeInfected;
+		unsigned int Status;
 		// cluster info
 		unsigned int Household;
 		unsigned int School;
@@ -192,6 +213,7 @@ private:
 			StartSympt = p.GetHealth().GetStartSymptomatic();
 			EndSympt = p.GetHealth().GetEndSymptomatic();
 			TimeInfected = p.GetHealth().GetDaysInfected();
+			Status = ToSizeType(p.GetHealth().GetHealthStatus());
 
 			Household = p.GetClusterId(ClusterType::Household);
 			School = p.GetClusterId(ClusterType::School);
@@ -199,13 +221,19 @@ private:
 			Primary = p.GetClusterId(ClusterType::PrimaryCommunity);
 			Secondary = p.GetClusterId(ClusterType::SecondaryCommunity);
 		}
-		h_personType() {}
-	};
+		/// Checkpoints written before the status was stored leave it at NumOfHealthStatuses().
+		h_personType() : Status(NumOfHealthStatuses()) {}
 
-	struct h_clusterType
-	{
-		unsigned int ID;
-		unsigned int PersonID;
+		bool operator==(const h_personType& other) const
+		{
+			return ID == other.ID && Age == other.Age && Gender == other.Gender &&
+			       Participating == other.Participating && Immune == other.Immune &&
+			       Infected == other.Infected && StartInf == other.StartInf && EndInf == other.EndInf &&
+			       StartSympt == other.StartSympt && EndSympt == other.EndSympt &&
+			       TimeInfected == other.TimeInfected && Status == other.Status &&
+			       Household == other.Household && School == other.School && Work == other.Work &&
+			       Primary == other.Primary && Secondary == other.Secondary;
+		}
 	};
 
 	struct h_visitorType
@@ -232,6 +260,31 @@ private:
 		unsigned int id;
 		const char* name;
 	};
+
+public:
+	struct Snapshot
+	{
+		/// The date under which the snapshot is written.
+		boost::gregorian::date date;
+
+		std::vector<h_personType> population;
+
+		std::vector<h_personType> expatriates;
+		std::vector<h_visitorType> visitors;
+	};
+
+private:
+	/// Loads the person records of the given date: those of the last full checkpoint before it, with the
+	/// deltas since then applied in order.
+	std::vector<h_personType> LoadPeople(const std::string& groupname);
+
+	/// Adds the person in the given record to the population, with the health they had when the record was
+	/// written.
+	static Person RestorePerson(Population& pop, const h_personType& data);
+
+	/// The snapshot that was written last, which the next delta is relative to. It is only kept while the
+	/// next checkpoint is going to be a delta.
+	std::unique_ptr<Snapshot> m_previous;
 };
 
 } /* namespace checkpoint */
@@ -1,13 +1,18 @@
 #include "checkpoint/CheckPoint.h"
+#include "sim/SimulatorBuilder.h"
 #include "sim/run_stride.h"
+#include "util/Stopwatch.h"
 
+#include <chrono>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <boost/filesystem.hpp>
 #include <tclap/CmdLine.h>
 
 using namespace std;
 using namespace stride;
+using namespace stride::util;
 using namespace TCLAP;
 
 std::unique_ptr<checkpoint::CheckPoint> cp;
@@ -58,6 +63,51 @@ void loadCP(const std::string& config, const std::string& disease, const std::st
 	std::cout << "Done loading" << std::endl;
 }
 
+/// Gets the throughput in MB/s of processing the given number of bytes in the given time.
+double megabytesPerSecond(std::uintmax_t bytes, const Stopwatch<>& clock)
+{
+	return static_cast<double>(bytes) / 1e6 / std::chrono::duration<double>(clock.Get()).count();
+}
+
+/// Restores the last checkpoint in the given file and reports how fast it is written to and read back from a
+/// temporary file. The throughput is measured in bytes on disk.
+void benchmarkCP(const std::string& filename, unsigned int compression)
+{
+	const std::string tmp_file = "tmp_benchmark.h5";
+
+	// Restore the last checkpoint in the file.
+	cp->OpenFile();
+	const auto date = cp->GetLastDate();
+	auto config = cp->LoadSingleConfig();
+	cp->CloseFile();
+	config.common_config->checkpoint_compression = compression;
+	auto sim = SimulatorBuilder::Load(config, nullptr, filename, date, 1);
+	std::cout << "Loaded " << sim->GetPopulation()->size() << " people from " << filename << std::endl;
+
+	checkpoint::CheckPoint out(tmp_file, compression);
+	out.CreateFile();
+
+	Stopwatch<> write_clock("write_clock", true);
+	out.OpenFile();
+	out.SaveCheckPoint(*sim, 0);
+	out.CloseFile();
+	write_clock.Stop();
+	const auto bytes = boost::filesystem::file_size(tmp_file);
+
+	Stopwatch<> read_clock("read_clock", true);
+	out.OpenFile();
+	out.LoadCheckPoint(sim->GetDate(), *sim);
+	out.CloseFile();
+	read_clock.Stop();
+
+	std::cout << "Checkpoint of " << bytes / 1e6 << " MB (compression level " << compression << ")" << std::endl
+		  << "  write: " << write_clock.ToString() << "  " << megabytesPerSecond(bytes, write_clock) << " MB/s"
+		  << std::endl
+		  << "  read:  " << read_clock.ToString() << "  " << megabytesPerSecond(bytes, read_clock) << " MB/s"
+		  << std::endl;
+	boost::filesystem::remove(tmp_file);
+}
+
 /// Main program of the stridecp program.
 int main(int argc, char** argv)
 {
@@ -81,6 +131,13 @@ int main(int argc, char** argv)
 		ValueArg<string> matrixfile(
 		    "m", "contact-matrix", "The contact matrix to load into or load from", false, "", "XML FILE", cmd);
 
+		SwitchArg benchmark(
+		    "b", "benchmark", "Time writing and reading the last checkpoint in the file", cmd, false);
+
+		ValueArg<unsigned int> compression(
+		    "z", "compression", "The deflate level (0-9) of the benchmarked checkpoint", false, 0, "LEVEL",
+		    cmd);
+
 		UnlabeledValueArg<string> checkpointfile(
 		    "checkpoint", "the file containing the checkpoint", true, "", "H5 FILE", cmd);
 
@@ -96,7 +153,9 @@ int main(int argc, char** argv)
 		// -----------------------------------------------------------------------------------------
 		verify_execution_environment();
 		cp = std::make_unique<checkpoint::CheckPoint>(checkpointfile.getValue());
-		if (store.getValue()) {
+		if (benchmark.getValue()) {
+			benchmarkCP(checkpointfile.getValue(), compression.getValue());
+		} else if (store.getValue()) {
 			storeCP(configfile.getValue(), diseasefile.getValue(), matrixfile.getValue());
 		} else {
 			loadCP(configfile.getValue(), diseasefile.getValue(), matrixfile.getValue());
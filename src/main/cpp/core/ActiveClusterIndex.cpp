@@ -0,0 +1,59 @@
+#include "ActiveClusterIndex.h"
+
+#include "util/Errors.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+
+void ActiveClusterIndex::AddInfectious(ClusterType type, size_t index)
+{
+	auto& entries = m_entries[ToSizeType(type)];
+	if (index >= entries.size()) {
+		entries.resize(index + 1);
+	}
+
+	auto& entry = entries[index];
+	if (entry.count == 0) {
+		entry.position = m_active.size();
+		m_active.emplace_back(type, index);
+	}
+	entry.count++;
+}
+
+void ActiveClusterIndex::RemoveInfectious(ClusterType type, size_t index)
+{
+	auto& entries = m_entries[ToSizeType(type)];
+	if (index >= entries.size() || entries[index].count == 0) {
+		FATAL_ERROR("Cluster " + to_string(index) + " of type " + ToString(type) + " has no infectious members.");
+	}
+
+	auto& entry = entries[index];
+	entry.count--;
+	if (entry.count == 0) {
+		// Swap the last active cluster into this cluster's place.
+		const auto last = m_active.back();
+		m_active[entry.position] = last;
+		m_entries[ToSizeType(last.first)][last.second].position = entry.position;
+		m_active.pop_back();
+	}
+}
+
+unsigned int ActiveClusterIndex::GetInfectiousCount(ClusterType type, size_t index) const
+{
+	const auto& entries = m_entries[ToSizeType(type)];
+	return index < entries.size() ? entries[index].count : 0;
+}
+
+void ActiveClusterIndex::Clear()
+{
+	for (auto& entries : m_entries) {
+		entries.clear();
+	}
+	m_active.clear();
+}
+
+} // end_of_namespace
@@ -0,0 +1,60 @@
+#ifndef ACTIVE_CLUSTER_INDEX_H_INCLUDED
+#define ACTIVE_CLUSTER_INDEX_H_INCLUDED
+
+#include "core/ClusterType.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Keeps track of the clusters that have at least one infectious member. Clusters are
+ * identified by their type and their index in the simulator's list of clusters of that
+ * type. Adding, removing and testing clusters all take constant time; the active clusters
+ * can be listed in time proportional to their number.
+ */
+class ActiveClusterIndex
+{
+public:
+	/// Identifies a cluster by its type and index.
+	using Key = std::pair<ClusterType, std::size_t>;
+
+	/// Records that the given cluster has gained an infectious member.
+	void AddInfectious(ClusterType type, std::size_t index);
+
+	/// Records that the given cluster has lost an infectious member.
+	void RemoveInfectious(ClusterType type, std::size_t index);
+
+	/// Gets the number of infectious members of the given cluster.
+	unsigned int GetInfectiousCount(ClusterType type, std::size_t index) const;
+
+	/// Tests if the given cluster has at least one infectious member.
+	bool IsActive(ClusterType type, std::size_t index) const { return GetInfectiousCount(type, index) > 0; }
+
+	/// Gets the clusters that have at least one infectious member, in no particular order.
+	const std::vector<Key>& GetActiveClusters() const { return m_active; }
+
+	/// Forgets about all infectious members.
+	void Clear();
+
+private:
+	/// Bookkeeping for a single cluster.
+	struct Entry
+	{
+		/// The number of infectious members.
+		unsigned int count = 0;
+
+		/// The cluster's position in m_active, if it is active.
+		std::size_t position = 0;
+	};
+
+	std::array<std::vector<Entry>, NumOfClusterTypes()> m_entries;
+	std::vector<Key> m_active;
+};
+
+} // end_of_namespace
+
+#endif // include-guard
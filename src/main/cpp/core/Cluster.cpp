@@ -5,6 +5,7 @@
 #include "calendar/Calendar.h"
 #include "pop/Person.h"
 
+#include <cmath>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -15,96 +16,105 @@ namespace stride {
 using namespace std;
 
 std::array<ContactProfile, NumOfClusterTypes()> Cluster::g_profiles;
+unsigned int Cluster::g_profile_generation = 1;
 
 Cluster::Cluster(std::size_t cluster_id, ClusterType cluster_type)
-    : m_cluster_id(cluster_id), m_cluster_type(cluster_type), m_index_immune(0),
-      m_profile(g_profiles.at(ToSizeType(m_cluster_type)))
+    : m_cluster_id(cluster_id), m_cluster_type(cluster_type), m_index_susceptible(0), m_index_immune(0), m_store(nullptr),
+      m_profile(g_profiles.at(ToSizeType(m_cluster_type))), m_probability_table_size(0),
+      m_probability_table_multiplier(0.0), m_probability_table_generation(0)
 {
 }
 
 void Cluster::AddContactProfile(ClusterType cluster_type, const ContactProfile& profile)
 {
 	g_profiles.at(ToSizeType(cluster_type)) = profile;
+	g_profile_generation++;
 }
 
-void Cluster::AddPerson(const Person& p)
+const std::vector<double>& Cluster::GetProbabilityTable(double multiplier)
 {
-	if (p.GetHealth().IsImmune()) {
-		m_members.emplace_back(std::make_pair(p, p.IsInCluster(m_cluster_type)));
-	} else {
-		m_members.emplace(m_members.begin() + m_index_immune, std::make_pair(p, p.IsInCluster(m_cluster_type)));
-		m_index_immune++;
+	if (m_probability_table_size != m_members.size() || m_probability_table_multiplier != multiplier ||
+	    m_probability_table_generation != g_profile_generation) {
+		m_probability_table.resize(m_profile.size());
+		for (std::size_t age = 0; age < m_profile.size(); age++) {
+			const double contact_rate = m_profile[age] / m_members.size();
+			m_probability_table[age] = 1 - exp(-(multiplier * contact_rate));
+		}
+		m_probability_table_size = m_members.size();
+		m_probability_table_multiplier = multiplier;
+		m_probability_table_generation = g_profile_generation;
 	}
+	return m_probability_table;
 }
 
-void Cluster::RemovePerson(const Person& p)
+std::vector<Person> Cluster::GetPeople() const
 {
-	std::size_t index = 0;
-	while (index < m_members.size()) {
-		if (m_members[index].first == p) {
-			m_members.erase(m_members.begin() + index);
-			if (m_index_immune == index) {
-				m_index_immune++;
-			}
-			if (m_index_immune > m_members.size()) {
-				m_index_immune = m_members.size();
-			}
-			return;
-		}
-		index++;
+	std::vector<Person> people;
+	people.reserve(m_members.size());
+	for (const auto id : m_members) {
+		people.emplace_back(m_store, id);
 	}
+	return people;
 }
 
-tuple<bool, std::size_t> Cluster::SortMembers()
+void Cluster::AddPerson(const Person& p)
 {
-	bool infectious_cases = false;
-	std::size_t num_cases = 0;
-
-	for (size_t i_member = 0; i_member < m_index_immune; i_member++) {
-		// if immune, move to back
-		if (m_members[i_member].first.GetHealth().IsImmune()) {
-			bool swapped = false;
-			std::size_t new_place = m_index_immune - 1;
-			m_index_immune--;
-			while (!swapped && new_place > i_member) {
-				if (m_members[new_place].first.GetHealth().IsImmune()) {
-					m_index_immune--;
-					new_place--;
-				} else {
-					swap(m_members[i_member], m_members[new_place]);
-					swapped = true;
-				}
-			}
-		}
-		// else, if not susceptible, move to front
-		else if (!m_members[i_member].first.GetHealth().IsSusceptible()) {
-			if (!infectious_cases && m_members[i_member].first.GetHealth().IsInfectious()) {
-				infectious_cases = true;
-			}
-			if (i_member > num_cases) {
-				swap(m_members[i_member], m_members[num_cases]);
-			}
-			num_cases++;
-		}
+	m_store = p.GetStore();
+	m_members.push_back(p.GetId());
+	std::size_t index = m_members.size() - 1;
+	PlaceMember(index, p.GetId());
+
+	// Rotate the new member into their partition, moving one member of every partition that
+	// follows it to that partition's end.
+	const auto partition = GetHealthPartition(p.GetHealth());
+	if (partition < 2) {
+		SwapMembers(index, m_index_immune);
+		index = m_index_immune++;
+	}
+	if (partition < 1) {
+		SwapMembers(index, m_index_susceptible);
+		m_index_susceptible++;
+	}
+}
+
+void Cluster::RemovePerson(const Person& p)
+{
+	std::size_t index = m_store->GetClusterIndex(p.GetId(), m_cluster_type);
+	if (index >= m_members.size() || m_members[index] != p.GetId()) {
+		return;
 	}
 
-	return make_tuple(infectious_cases, num_cases);
+	// Fill the hole with the last member of the same partition, and that member's slot with the
+	// last member of the next partition, and so on.
+	if (index < m_index_susceptible) {
+		SwapMembers(index, --m_index_susceptible);
+		index = m_index_susceptible;
+	}
+	if (index < m_index_immune) {
+		SwapMembers(index, --m_index_immune);
+		index = m_index_immune;
+	}
+	SwapMembers(index, m_members.size() - 1);
+	m_members.pop_back();
 }
 
-void Cluster::UpdateMemberPresence()
+void Cluster::MoveToCases(const Person& p)
 {
-	for (auto& member : m_members) {
-		member.second = member.first.IsInCluster(m_cluster_type);
+	const std::size_t index = m_store->GetClusterIndex(p.GetId(), m_cluster_type);
+	if (index >= m_index_susceptible && index < m_index_immune && m_members[index] == p.GetId()) {
+		SwapMembers(index, m_index_susceptible++);
 	}
 }
 
-std::vector<Person> Cluster::GetPeople() const
+std::size_t Cluster::GetInfectiousCount() const
 {
-	std::vector<Person> result;
-	for (auto& i : m_members) {
-		result.push_back(i.first);
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < m_index_susceptible; i++) {
+		if (GetMember(i).GetHealth().IsInfectious()) {
+			count++;
+		}
 	}
-	return result;
+	return count;
 }
 
 } // end_of_namespace
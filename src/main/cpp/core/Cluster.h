@@ -5,6 +5,7 @@
 #include "core/ClusterType.h"
 #include "core/ContactProfile.h"
 #include "core/LogMode.h"
+#include "pop/Age.h"
 #include "pop/Person.h"
 
 #include <array>
@@ -34,39 +35,69 @@ public:
 	/// Removes the given person from this cluster.
 	void RemovePerson(const Person& p);
 
+	/// Moves the given member, who was susceptible and has just been infected, to the cases.
+	void MoveToCases(const Person& p);
+
+	/// Reserves room for the given number of members.
+	void Reserve(std::size_t size) { m_members.reserve(size); }
+
 	/// Returns the ID of the cluster.
 	ClusterId GetId() const { return m_cluster_id; }
 
-	/// Returns the vector of people.
+	/// Builds a list of the people in this cluster.
 	std::vector<Person> GetPeople() const;
 
+	/// Gets the member at the given index.
+	Person GetMember(std::size_t index) const { return Person(m_store, m_members[index]); }
+
 	/// Return number of persons in this cluster.
 	std::size_t GetSize() const { return m_members.size(); }
 
+	/// Return the number of infectious members in this cluster.
+	std::size_t GetInfectiousCount() const;
+
+	/// Gets the partition of the member list that people with the given health belong in:
+	/// 0 for cases (exposed, infected or recovered), 1 for susceptible and 2 for immune people.
+	static std::size_t GetHealthPartition(const Health& health)
+	{
+		return health.IsImmune() ? 2 : health.IsSusceptible() ? 1 : 0;
+	}
+
 	/// Return the type of this cluster.
 	ClusterType GetClusterType() const { return m_cluster_type; }
 
 	/// Get basic contact rate in this cluster.
-	double GetContactRate(const Person& p) const
-	{
-		return g_profiles.at(ToSizeType(m_cluster_type))[EffectiveAge(p.GetAge())] / m_members.size();
-	}
+	double GetContactRate(const Person& p) const { return m_profile[EffectiveAge(p.GetAge())] / m_members.size(); }
+
+	/// Gets a table that maps (effective) ages to the probability 1 - exp(-multiplier * contact rate).
+	/// The table is cached, and only rebuilt when the cluster's size, the multiplier or the
+	/// contact profiles change.
+	const std::vector<double>& GetProbabilityTable(double multiplier);
 
 public:
 	/// Add contact profile.
 	static void AddContactProfile(ClusterType cluster_type, const ContactProfile& profile);
 
 private:
-	/// Sort members w.r.t. health status (order: exposed/infected/recovered, susceptible, immune).
-	std::tuple<bool, std::size_t> SortMembers();
+	/// Puts the given person at the given index of the member list, and updates their back-pointer.
+	void PlaceMember(std::size_t index, PersonId id)
+	{
+		m_members[index] = id;
+		m_store->GetClusterIndex(id, m_cluster_type) = static_cast<unsigned int>(index);
+	}
+
+	/// Swaps the members at the given indices.
+	void SwapMembers(std::size_t i, std::size_t j)
+	{
+		const auto id = m_members[i];
+		PlaceMember(i, m_members[j]);
+		PlaceMember(j, id);
+	}
 
 	/// Infector calculates contacts and transmissions.
 	template <LogMode log_level, bool track_index_case, typename local_information_policy>
 	friend class Infector;
 
-	/// Calculate which members are present in the cluster on the current day.
-	void UpdateMemberPresence();
-
 private:
 	/// The ID of the Cluster (for logging purposes).
 	ClusterId m_cluster_id;
@@ -74,16 +105,34 @@ private:
 	/// The type of the Cluster (for logging purposes).
 	ClusterType m_cluster_type;
 
+	/// Index of the first susceptible member in the Cluster. The members are partitioned by health
+	/// status: cases (exposed/infected/recovered) come first, then susceptible and then immune members.
+	std::size_t m_index_susceptible;
+
 	/// Index of the first immune member in the Cluster.
 	std::size_t m_index_immune;
 
-	/// Container with pointers to Cluster members.
-	std::vector<std::pair<Person, bool>> m_members;
+	/// The store the Cluster members live in. Set when the first member is added.
+	PersonStore* m_store;
+
+	/// The ids of the Cluster members. Everyone's index in this list is kept by the person store,
+	/// as is whether they are present today.
+	std::vector<PersonId> m_members;
 
 	const ContactProfile& m_profile;
 
+	/// Cached probability table, and the cluster size, multiplier and profile generation it was
+	/// computed for.
+	std::vector<double> m_probability_table;
+	std::size_t m_probability_table_size;
+	double m_probability_table_multiplier;
+	unsigned int m_probability_table_generation;
+
 private:
 	static std::array<ContactProfile, NumOfClusterTypes()> g_profiles;
+
+	/// Incremented every time a contact profile changes.
+	static unsigned int g_profile_generation;
 };
 
 } // end_of_namespace
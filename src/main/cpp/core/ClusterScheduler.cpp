@@ -0,0 +1,142 @@
+#include "ClusterScheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace stride {
+
+using namespace std;
+
+ClusterScheduler::ClusterScheduler(unsigned int num_workers)
+{
+	num_workers = max(num_workers, 1U);
+	for (unsigned int i = 0; i < num_workers; i++) {
+		m_workers.emplace_back(make_unique<Worker>());
+		m_worker_ids.push_back(i);
+	}
+}
+
+void ClusterScheduler::PlanAll(const vector<vector<Cluster>*>& cluster_lists)
+{
+	vector<Cluster*> clusters;
+	for (auto list : cluster_lists) {
+		for (auto& cluster : *list) {
+			clusters.push_back(&cluster);
+		}
+	}
+	Plan(clusters);
+}
+
+void ClusterScheduler::Plan(const vector<Cluster*>& clusters)
+{
+	if (m_workers.size() == 1) {
+		// A single worker does all of the work anyway, so there's no point in estimating costs.
+		auto& worker = *m_workers[0];
+		worker.m_tasks = clusters;
+		worker.m_front = 0;
+		worker.m_back = worker.m_tasks.size();
+		return;
+	}
+
+	m_tasks.clear();
+	for (auto cluster : clusters) {
+		m_tasks.push_back({cluster, 0});
+	}
+
+	// A cluster's cost is dominated by the contacts between its infectious members and
+	// everyone else; every member is visited at least once.
+	util::parallel::parallel_for(m_tasks, GetNumberOfWorkers(), [](Task& task, unsigned int) {
+		const auto size = task.cluster->GetSize();
+		task.cost = size * (1 + task.cluster->GetInfectiousCount());
+	});
+	stable_sort(m_tasks.begin(), m_tasks.end(), [](const Task& lhs, const Task& rhs) {
+		return lhs.cost > rhs.cost;
+	});
+
+	// Deal out the clusters, most expensive first, to the worker with the least work.
+	using Load = pair<size_t, size_t>;
+	priority_queue<Load, vector<Load>, greater<Load>> loads;
+	for (size_t i = 0; i < m_workers.size(); i++) {
+		auto& worker = *m_workers[i];
+		worker.m_tasks.clear();
+		loads.emplace(0, i);
+	}
+	for (const auto& task : m_tasks) {
+		auto load = loads.top();
+		loads.pop();
+		m_workers[load.second]->m_tasks.push_back(task.cluster);
+		loads.emplace(load.first + task.cost, load.second);
+	}
+	for (auto& worker : m_workers) {
+		worker->m_front = 0;
+		worker->m_back = worker->m_tasks.size();
+	}
+}
+
+vector<ClusterScheduler::WorkerTimes> ClusterScheduler::GetWorkerTimes() const
+{
+	vector<WorkerTimes> result;
+	for (const auto& worker : m_workers) {
+		result.push_back(worker->m_times);
+	}
+	return result;
+}
+
+Cluster* ClusterScheduler::PopFront(Worker& worker)
+{
+	lock_guard<mutex> lock(worker.m_mutex);
+	if (worker.m_front == worker.m_back) {
+		return nullptr;
+	}
+	return worker.m_tasks[worker.m_front++];
+}
+
+bool ClusterScheduler::Steal(size_t thief_id)
+{
+	auto& thief = *m_workers[thief_id];
+	while (true) {
+		// Find the worker with the most clusters left. This is only a hint: the victim
+		// may run out of work before we get to it, in which case we simply look again.
+		size_t victim_id = thief_id;
+		size_t most_left = 0;
+		for (size_t i = 0; i < m_workers.size(); i++) {
+			if (i == thief_id) {
+				continue;
+			}
+			auto& worker = *m_workers[i];
+			lock_guard<mutex> lock(worker.m_mutex);
+			const auto left = worker.m_back - worker.m_front;
+			if (left > most_left) {
+				most_left = left;
+				victim_id = i;
+			}
+		}
+		if (victim_id == thief_id) {
+			return false;
+		}
+
+		vector<Cluster*> stolen;
+		{
+			auto& victim = *m_workers[victim_id];
+			lock_guard<mutex> lock(victim.m_mutex);
+			const auto left = victim.m_back - victim.m_front;
+			if (left == 0) {
+				continue;
+			}
+			const auto mid = victim.m_back - (left + 1) / 2;
+			stolen.assign(victim.m_tasks.begin() + mid, victim.m_tasks.begin() + victim.m_back);
+			victim.m_back = mid;
+		}
+
+		lock_guard<mutex> lock(thief.m_mutex);
+		thief.m_tasks = move(stolen);
+		thief.m_front = 0;
+		thief.m_back = thief.m_tasks.size();
+		thief.m_times.steals++;
+		return true;
+	}
+}
+
+} // end_of_namespace
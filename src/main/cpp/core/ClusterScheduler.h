@@ -0,0 +1,145 @@
+#ifndef CLUSTER_SCHEDULER_H_INCLUDED
+#define CLUSTER_SCHEDULER_H_INCLUDED
+
+#include "core/Cluster.h"
+#include "util/Parallel.h"
+#include "util/Stopwatch.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Schedules a pass over a set of clusters on a fixed number of workers. Clusters are sorted
+ * by their estimated cost and dealt out to the workers, largest first, such that every worker
+ * starts out with roughly the same amount of work. Workers that run out of clusters steal half
+ * of the remaining clusters of the most heavily loaded worker.
+ *
+ * The clusters of a pass are processed concurrently, so they must not share any members: the
+ * simulator plans a separate pass for every cluster type.
+ *
+ * Worker i always runs on a single thread for the duration of a pass and is the only
+ * worker that is handed the index i, so it can use per-thread state (e.g., the i-th
+ * RngHandler) without synchronization.
+ */
+class ClusterScheduler
+{
+public:
+	using Duration = util::Stopwatch<>::TDuration;
+
+	/// Time spent by a single worker, accumulated over all passes.
+	struct WorkerTimes
+	{
+		/// Time spent processing (or looking for) clusters.
+		Duration busy = Duration::zero();
+
+		/// Time spent waiting for the other workers to finish a pass.
+		Duration idle = Duration::zero();
+
+		/// The number of clusters that were processed.
+		std::size_t clusters = 0;
+
+		/// The number of times this worker stole clusters from another worker.
+		std::size_t steals = 0;
+	};
+
+	/// Creates a scheduler for the given number of workers.
+	explicit ClusterScheduler(unsigned int num_workers);
+
+	/// Gets the number of workers.
+	unsigned int GetNumberOfWorkers() const { return static_cast<unsigned int>(m_workers.size()); }
+
+	/// Plans the next pass over every cluster in the given lists.
+	void PlanAll(const std::vector<std::vector<Cluster>*>& cluster_lists);
+
+	/// Plans the next pass over the given clusters.
+	void Plan(const std::vector<Cluster*>& clusters);
+
+	/// Runs the planned pass. `action` is a function object with signature
+	/// `void(Cluster&, unsigned int worker_id)`.
+	template <typename TAction>
+	void Run(const TAction& action);
+
+	/// Gets the time spent by each worker so far.
+	std::vector<WorkerTimes> GetWorkerTimes() const;
+
+private:
+	/// A cluster to process, and the estimated cost of processing it.
+	struct Task
+	{
+		Cluster* cluster;
+		std::size_t cost;
+	};
+
+	/// The clusters that have been handed to a single worker.
+	struct Worker
+	{
+		/// Guards m_tasks, m_front and m_back.
+		std::mutex m_mutex;
+
+		/// The worker's clusters. It takes them from the front, thieves take them from the back.
+		std::vector<Cluster*> m_tasks;
+		std::size_t m_front = 0;
+		std::size_t m_back = 0;
+
+		/// Statistics for this worker.
+		WorkerTimes m_times;
+	};
+
+	/// Takes the next cluster from the given worker's own queue, or returns nullptr.
+	static Cluster* PopFront(Worker& worker);
+
+	/// Moves half of the clusters from the most loaded worker to the given (idle) worker.
+	/// Returns false if there was nothing left to steal.
+	bool Steal(std::size_t thief_id);
+
+	/// Processes clusters on the given worker until there is no work left anywhere.
+	template <typename TAction>
+	void RunWorker(std::size_t worker_id, const TAction& action);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<unsigned int> m_worker_ids;
+	std::vector<Task> m_tasks;
+};
+
+template <typename TAction>
+void ClusterScheduler::RunWorker(std::size_t worker_id, const TAction& action)
+{
+	auto& worker = *m_workers[worker_id];
+	const auto start = std::chrono::system_clock::now();
+	do {
+		while (auto cluster = PopFront(worker)) {
+			action(*cluster, static_cast<unsigned int>(worker_id));
+			worker.m_times.clusters++;
+		}
+	} while (Steal(worker_id));
+	worker.m_times.busy += std::chrono::system_clock::now() - start;
+}
+
+template <typename TAction>
+void ClusterScheduler::Run(const TAction& action)
+{
+	std::vector<Duration> busy_before;
+	for (const auto& worker : m_workers) {
+		busy_before.push_back(worker->m_times.busy);
+	}
+
+	const auto start = std::chrono::system_clock::now();
+	util::parallel::parallel_for(
+	    m_worker_ids, GetNumberOfWorkers(),
+	    [this, &action](unsigned int worker_id, unsigned int) { RunWorker(worker_id, action); });
+	const auto pass_time = std::chrono::system_clock::now() - start;
+
+	for (std::size_t i = 0; i < m_workers.size(); i++) {
+		auto& times = m_workers[i]->m_times;
+		times.idle += pass_time - (times.busy - busy_before[i]);
+	}
+}
+
+} // end_of_namespace
+
+#endif // include-guard
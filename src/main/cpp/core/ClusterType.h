@@ -21,7 +21,7 @@ enum class ClusterType
 inline constexpr unsigned int NumOfClusterTypes() { return 5U; }
 
 /// Cast for array access.
-inline std::size_t ToSizeType(ClusterType c) { return static_cast<std::size_t>(c); }
+inline constexpr std::size_t ToSizeType(ClusterType c) { return static_cast<std::size_t>(c); }
 
 /// Converts a ClusterType value to corresponding name.
 std::string ToString(ClusterType w);
@@ -1,5 +1,7 @@
 #include <iostream>
+#include <string>
 #include "Disease.h"
+#include "util/Errors.h"
 
 namespace stride {
 namespace disease {
@@ -41,16 +43,26 @@ Fate Disease::Sample(Random& rng) const
 	const unsigned int ss = start_symptomatic.Sample(rng);
 	const unsigned int ti = time_infectious.Sample(rng);
 	const unsigned int ts = time_symptomatic.Sample(rng);
-	return Fate{si, ss, si + ti, ss + ts};
+	return Fate{static_cast<std::uint8_t>(si), static_cast<std::uint8_t>(ss), static_cast<std::uint8_t>(si + ti),
+		    static_cast<std::uint8_t>(ss + ts)};
 }
 
 std::unique_ptr<Disease> Disease::Parse(const ptree& pt_disease)
 {
-	return std::make_unique<Disease>( //
+	auto result = std::make_unique<Disease>( //
 	    *Distribution::Parse(pt_disease.get_child("disease.start_infectiousness")),
 	    *Distribution::Parse(pt_disease.get_child("disease.start_symptomatic")),
 	    *Distribution::Parse(pt_disease.get_child("disease.time_infectious")),
 	    *Distribution::Parse(pt_disease.get_child("disease.time_symptomatic")));
+
+	// The last day of a Fate is the sum of the largest values of two distributions.
+	const auto largest = [](const Distribution& d) { return d.GetSize() > 0 ? d.GetSize() - 1 : 0; };
+	const auto last_infectious = largest(result->start_infectiousness) + largest(result->time_infectious);
+	const auto last_symptomatic = largest(result->start_symptomatic) + largest(result->time_symptomatic);
+	if (last_infectious > MaxFateDay() || last_symptomatic > MaxFateDay()) {
+		FATAL_ERROR("The disease lasts longer than " + std::to_string(MaxFateDay()) + " days.");
+	}
+	return result;
 }
 
 } // namespace disease
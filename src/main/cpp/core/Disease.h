@@ -4,20 +4,27 @@
 #include <boost/property_tree/ptree.hpp>
 #include "util/Random.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 namespace stride {
 namespace disease {
 
 // A Fate records how many days into the simulation a Person will become
 // infectious/symptomatic, and for how long. It is assigned to each Person
-// when the simulation starts, hence the name.
+// when the simulation starts, hence the name. Every day is stored in a single byte.
 struct Fate
 {
-	unsigned int start_infectiousness;
-	unsigned int start_symptomatic;
-	unsigned int end_infectiousness;
-	unsigned int end_symptomatic;
+	std::uint8_t start_infectiousness;
+	std::uint8_t start_symptomatic;
+	std::uint8_t end_infectiousness;
+	std::uint8_t end_symptomatic;
 };
 
+// The last day that a Fate can record.
+inline constexpr unsigned int MaxFateDay() { return std::numeric_limits<std::uint8_t>::max(); }
+
 // A Distribution is, essentially, the cumulative sum of a list `v` of n positive reals
 // that sum to 1, representing a probability distribution over {0, 1, ..., n-1}.
 // See the Sample method.
@@ -31,6 +38,9 @@ public:
 	// probability `v[i]`.
 	unsigned int Sample(util::Random& rng) const;
 
+	// Return the number of values this distribution can yield.
+	std::size_t GetSize() const { return probabilities.size(); }
+
 	static std::unique_ptr<Distribution> Parse(const boost::property_tree::ptree& pt_probability_list);
 
 private:
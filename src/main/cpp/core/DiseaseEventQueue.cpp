@@ -0,0 +1,81 @@
+#include "DiseaseEventQueue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace stride {
+
+using namespace std;
+
+DiseaseEventQueue::DiseaseEventQueue() : m_day(0), m_buckets(1) {}
+
+void DiseaseEventQueue::Update(PersonId id, const Health& health)
+{
+	if (!health.IsInfected()) {
+		Remove(id);
+		return;
+	}
+
+	const auto days = health.GetDaysToNextTransition();
+	auto& entry = m_entries[id];
+	entry.last_day = m_day;
+	entry.next_day = days > 0 ? m_day + days : 0;
+	if (days > 0) {
+		Schedule(id, entry.next_day);
+	}
+}
+
+void DiseaseEventQueue::Remove(PersonId id) { m_entries.erase(id); }
+
+unsigned int DiseaseEventQueue::GetDaysBehind(PersonId id) const
+{
+	const auto it = m_entries.find(id);
+	return it == m_entries.end() ? 0 : m_day - it->second.last_day;
+}
+
+vector<PersonId> DiseaseEventQueue::AdvanceDay()
+{
+	m_day++;
+	vector<PersonId> bucket;
+	swap(bucket, m_buckets[m_day % m_buckets.size()]);
+
+	// Drop the people who were removed or rescheduled, and those that are in the bucket twice.
+	vector<PersonId> result;
+	for (const auto id : bucket) {
+		const auto it = m_entries.find(id);
+		if (it != m_entries.end() && it->second.next_day == m_day) {
+			it->second.next_day = 0;
+			result.push_back(id);
+		}
+	}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+void DiseaseEventQueue::Clear()
+{
+	m_entries.clear();
+	for (auto& bucket : m_buckets) {
+		bucket.clear();
+	}
+}
+
+void DiseaseEventQueue::Schedule(PersonId id, unsigned int day)
+{
+	const auto size = m_buckets.size();
+	if (day - m_day >= size) {
+		// Every scheduled day is in (m_day, m_day + size), so the buckets can be moved to a larger ring.
+		auto new_size = 2 * size;
+		while (day - m_day >= new_size) {
+			new_size *= 2;
+		}
+		vector<vector<PersonId>> buckets(new_size);
+		for (unsigned int d = m_day + 1; d < m_day + size; d++) {
+			swap(buckets[d % new_size], m_buckets[d % size]);
+		}
+		swap(buckets, m_buckets);
+	}
+	m_buckets[day % m_buckets.size()].push_back(id);
+}
+
+} // end_of_namespace
@@ -0,0 +1,73 @@
+#ifndef DISEASE_EVENT_QUEUE_H_INCLUDED
+#define DISEASE_EVENT_QUEUE_H_INCLUDED
+
+#include "core/Health.h"
+#include "pop/Person.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace stride {
+
+/**
+ * A calendar queue of the days on which the disease of infected people changes, so that only the
+ * people whose health changes on a given day have to be updated on that day. Each day has a bucket
+ * of people in a ring of buckets; the ring grows when someone is scheduled further ahead than it
+ * reaches. The queue also remembers the day up to which each infected person's health was updated,
+ * so the days they have been infected can be brought up to date when they are needed.
+ */
+class DiseaseEventQueue
+{
+public:
+	/// Creates an empty queue.
+	DiseaseEventQueue();
+
+	/// Records that the given person's health is up to date as of the current day, and schedules
+	/// the next day on which their disease changes. People who aren't infected are forgotten.
+	void Update(PersonId id, const Health& health);
+
+	/// Forgets about the given person.
+	void Remove(PersonId id);
+
+	/// Gets the number of days that have passed since the given person's health was last updated.
+	unsigned int GetDaysBehind(PersonId id) const;
+
+	/// Moves on to the next day and returns the people whose disease changes on that day, ordered
+	/// by id. Every one of them must be updated before the next day.
+	std::vector<PersonId> AdvanceDay();
+
+	/// Gets the number of infected people in the queue.
+	std::size_t GetSize() const { return m_entries.size(); }
+
+	/// Forgets about everyone.
+	void Clear();
+
+private:
+	/// Bookkeeping for a single infected person.
+	struct Entry
+	{
+		/// The day up to which the person's health was updated.
+		unsigned int last_day;
+
+		/// The day on which the person's disease changes next, or 0 if it doesn't.
+		unsigned int next_day;
+	};
+
+	/// Adds the given person to the bucket of the given day, which must be after the current day.
+	void Schedule(PersonId id, unsigned int day);
+
+	/// The current day.
+	unsigned int m_day;
+
+	/// The infected people.
+	std::unordered_map<PersonId, Entry> m_entries;
+
+	/// The ring of buckets: day d is in bucket d % m_buckets.size(). People who were rescheduled
+	/// or removed are only dropped from their bucket on its day.
+	std::vector<std::vector<PersonId>> m_buckets;
+};
+
+} // end_of_namespace
+
+#endif // include-guard
@@ -12,6 +12,9 @@ public:
 	/// Initialize.
 	DiseaseProfile() : m_transmission_rate(0.0) {}
 
+	/// Initialize with the given transmission rate.
+	explicit DiseaseProfile(double transmission_rate) : m_transmission_rate(transmission_rate) {}
+
 	/// Return transmission rate.
 	double GetTransmissionRate() { return m_transmission_rate; }
 
@@ -1,11 +1,29 @@
 #include "Health.h"
 
+#include <algorithm>
+#include <array>
 #include <assert.h>
+#include <initializer_list>
+#include <string>
 
 namespace stride {
 
+std::string ToString(HealthStatus s)
+{
+	static const std::array<std::string, NumOfHealthStatuses()> names{
+	    {"Susceptible", "Exposed", "Infectious", "Symptomatic", "InfectiousAndSymptomatic", "Recovered", "Immune"}};
+	return names[ToSizeType(s)];
+}
+
 Health::Health(disease::Fate fate) : m_days_infected(0), m_status(HealthStatus::Susceptible), m_fate(fate) {}
 
+Health::Health(disease::Fate fate, HealthStatus status, unsigned int days_infected)
+    : m_days_infected(static_cast<DaysInfected>(
+	  std::min<unsigned int>(days_infected, std::numeric_limits<DaysInfected>::max()))),
+      m_status(status), m_fate(fate)
+{
+}
+
 void Health::SetImmune()
 {
 	m_status = HealthStatus::Immune;
@@ -56,4 +74,28 @@ void Health::Update()
 	}
 }
 
+void Health::Update(unsigned int days)
+{
+	if (days > 0 && IsInfected()) {
+		// None of the days before the last one change the status.
+		m_days_infected = static_cast<DaysInfected>(std::min<unsigned int>(
+		    m_days_infected + days - 1, std::numeric_limits<DaysInfected>::max()));
+		Update();
+	}
+}
+
+unsigned int Health::GetDaysToNextTransition() const
+{
+	unsigned int result = 0;
+	if (IsInfected()) {
+		for (const unsigned int day : {GetStartInfectiousness(), GetEndInfectiousness(), GetStartSymptomatic(),
+					       GetEndSymptomatic()}) {
+			if (day > GetDaysInfected() && (result == 0 || day - GetDaysInfected() < result)) {
+				result = day - GetDaysInfected();
+			}
+		}
+	}
+	return result;
+}
+
 } // namespace stride
@@ -3,9 +3,14 @@
 
 #include "Disease.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
 namespace stride {
 
-enum class HealthStatus
+enum class HealthStatus : std::uint8_t
 {
 	Susceptible = 0U,
 	Exposed = 1U,
@@ -16,8 +21,18 @@ enum class HealthStatus
 	Immune = 6U,
 };
 
+/// Number of health statuses.
+inline constexpr unsigned int NumOfHealthStatuses() { return 7U; }
+
+/// Cast for array access.
+inline constexpr std::size_t ToSizeType(HealthStatus s) { return static_cast<std::size_t>(s); }
+
+/// Converts a HealthStatus value to corresponding name.
+std::string ToString(HealthStatus s);
+
 /*
- * Represents the status of a Person's health at some point in the simulation.
+ * Represents the status of a Person's health at some point in the simulation. It is packed into
+ * a few bytes, because every person has one.
  */
 class Health
 {
@@ -25,6 +40,9 @@ public:
 	/// Initially, a person is Susceptible, and the "days infected" counter is set to 0.
 	Health(disease::Fate fate);
 
+	/// Restores a person's health, e.g. from a checkpoint.
+	Health(disease::Fate fate, HealthStatus status, unsigned int days_infected);
+
 	/// Return the person's current health status.
 	HealthStatus GetHealthStatus() const { return m_status; }
 
@@ -87,19 +105,33 @@ public:
 	/// Update progress of the disease.
 	void Update();
 
+	/// Update progress of the disease over the given number of days. The disease must not reach
+	/// any of the days of its fate before the last of those days (see GetDaysToNextTransition).
+	void Update(unsigned int days);
+
+	/// Get the number of days until the disease reaches the next day of its fate, or 0 if it won't.
+	unsigned int GetDaysToNextTransition() const;
+
 	/// Get the disease counter.
 	unsigned int GetDaysInfected() const { return m_days_infected; }
 
 private:
-	/// Increment disease counter.
-	void IncrementDaysInfected() { m_days_infected++; }
+	/// Increment disease counter. It stops at its maximum, long after the last day of any fate.
+	void IncrementDaysInfected()
+	{
+		if (m_days_infected < std::numeric_limits<DaysInfected>::max()) {
+			m_days_infected++;
+		}
+	}
 
 	/// Reset the disease counter.
 	void ResetDaysInfected() { m_days_infected = 0U; }
 
 private:
+	using DaysInfected = std::uint16_t;
+
 	/// The day counter (starts at 0, increased daily while the person is infected).
-	unsigned int m_days_infected;
+	DaysInfected m_days_infected;
 
 	/// The current health status.
 	HealthStatus m_status;
@@ -108,6 +140,8 @@ private:
 	disease::Fate m_fate;
 };
 
+static_assert(sizeof(Health) <= 8, "Health should fit in 8 bytes.");
+
 } // end of namespace
 
 #endif
@@ -0,0 +1,62 @@
+#ifndef HEALTH_COUNTS_H_INCLUDED
+#define HEALTH_COUNTS_H_INCLUDED
+
+#include "core/Health.h"
+
+#include <array>
+#include <cstddef>
+
+namespace stride {
+
+/**
+ * Counts people per health status. The counts are signed, so the same class also records
+ * how the counts change while people move from one status to another.
+ */
+class HealthCounts
+{
+public:
+	/// Creates counts that are all zero.
+	HealthCounts() { m_counts.fill(0); }
+
+	/// Gets the count for the given status.
+	std::ptrdiff_t Get(HealthStatus status) const { return m_counts[ToSizeType(status)]; }
+
+	/// Adds the given number of people to the count for the given status.
+	void Add(HealthStatus status, std::ptrdiff_t count = 1) { m_counts[ToSizeType(status)] += count; }
+
+	/// Removes the given number of people from the count for the given status.
+	void Remove(HealthStatus status, std::ptrdiff_t count = 1) { m_counts[ToSizeType(status)] -= count; }
+
+	/// Records that a person moved from one status to another.
+	void Move(HealthStatus from, HealthStatus to)
+	{
+		m_counts[ToSizeType(from)]--;
+		m_counts[ToSizeType(to)]++;
+	}
+
+	/// Gets the number of people who are or were infected: the cumulative number of cases.
+	std::ptrdiff_t GetCases() const
+	{
+		return Get(HealthStatus::Exposed) + Get(HealthStatus::Infectious) + Get(HealthStatus::Symptomatic) +
+		       Get(HealthStatus::InfectiousAndSymptomatic) + Get(HealthStatus::Recovered);
+	}
+
+	/// Adds the given counts to these counts.
+	HealthCounts& operator+=(const HealthCounts& other)
+	{
+		for (std::size_t i = 0; i < m_counts.size(); i++) {
+			m_counts[i] += other.m_counts[i];
+		}
+		return *this;
+	}
+
+	/// Sets all counts to zero.
+	void Clear() { m_counts.fill(0); }
+
+private:
+	std::array<std::ptrdiff_t, NumOfHealthStatuses()> m_counts;
+};
+
+} // end_of_namespace
+
+#endif // include-guard
@@ -1,15 +1,17 @@
 #include "calendar/Calendar.h"
 #include "core/Cluster.h"
 #include "core/Health.h"
+#include "core/HealthCounts.h"
 #include "core/Infector.h"
 #include "core/LogMode.h"
+#include "pop/Age.h"
 #include "pop/Person.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
-#include <spdlog/spdlog.h>
 #include "RngHandler.h"
 
 namespace stride {
@@ -36,6 +38,22 @@ public:
 	static void Execute(const Person& p) { p.GetHealth().StopInfection(); }
 };
 
+/// Records the change in health status of a person who was susceptible and has just been infected.
+inline void RecordInfection(HealthCounts& health_changes, std::vector<PersonId>& new_cases, const Person& p)
+{
+	health_changes.Move(HealthStatus::Susceptible, p.GetHealth().GetHealthStatus());
+	new_cases.push_back(p.GetId());
+}
+
+/// Creates the record of a contact or transmission from p1 to p2.
+inline output::EventRecord MakeEvent(
+    output::EventKind kind, const Person& p1, const Person& p2, ClusterType cluster_type, const CalendarRef& calendar)
+{
+	return {static_cast<std::uint32_t>(calendar->GetSimulationDay()), p1.GetId(), p2.GetId(),
+		static_cast<float>(p1.GetAge()), static_cast<float>(p2.GetAge()), kind,
+		static_cast<std::uint8_t>(cluster_type), 0, 0};
+}
+
 /**
  * Primary LOG_POLICY policy, implements LogMode::None.
  */
@@ -44,7 +62,7 @@ class LOG_POLICY
 {
 public:
 	static void Execute(
-	    const shared_ptr<spdlog::logger>& logger, const Person& p1, const Person& p2, ClusterType cluster_type,
+	    output::EventLog::Writer* events, const Person& p1, const Person& p2, ClusterType cluster_type,
 	    const CalendarRef& environ)
 	{
 	}
@@ -58,11 +76,10 @@ class LOG_POLICY<LogMode::Transmissions>
 {
 public:
 	static void Execute(
-	    const shared_ptr<spdlog::logger>& logger, const Person& p1, const Person& p2, ClusterType cluster_type,
+	    output::EventLog::Writer* events, const Person& p1, const Person& p2, ClusterType cluster_type,
 	    const CalendarRef& environ)
 	{
-		logger->info(
-		    "[TRAN] {} {} {} {}", p1.GetId(), p2.GetId(), ToString(cluster_type), environ->GetSimulationDay());
+		events->Append(MakeEvent(output::EventKind::Transmission, p1, p2, cluster_type, environ));
 	}
 };
 
@@ -74,18 +91,10 @@ class LOG_POLICY<LogMode::Contacts>
 {
 public:
 	static void Execute(
-	    const shared_ptr<spdlog::logger>& logger, const Person& p1, const Person& p2, ClusterType cluster_type,
+	    output::EventLog::Writer* events, const Person& p1, const Person& p2, ClusterType cluster_type,
 	    const CalendarRef& calendar)
 	{
-		unsigned int home = (cluster_type == ClusterType::Household);
-		unsigned int work = (cluster_type == ClusterType::Work);
-		unsigned int school = (cluster_type == ClusterType::School);
-		unsigned int primary_community = (cluster_type == ClusterType::PrimaryCommunity);
-		unsigned int secundary_community = (cluster_type == ClusterType::SecondaryCommunity);
-
-		logger->info(
-		    "[CONT] {} {} {} {} {} {} {} {} {}", p1.GetId(), p1.GetAge(), p2.GetAge(), home, school, work,
-		    primary_community, secundary_community, calendar->GetSimulationDay());
+		events->Append(MakeEvent(output::EventKind::Contact, p1, p2, cluster_type, calendar));
 	}
 };
 
@@ -97,51 +106,51 @@ public:
 //--------------------------------------------------------------------------
 template <LogMode log_level, bool track_index_case, typename local_information_policy>
 void Infector<log_level, track_index_case, local_information_policy>::Execute(
-    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& calendar,
-    const std::shared_ptr<spdlog::logger>& logger)
+    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+    std::vector<PersonId>& new_cases, const CalendarRef& calendar, output::EventLog::Writer* events)
 {
-	cluster.UpdateMemberPresence();
-
 	// set up some stuff
 	const auto c_type = cluster.m_cluster_type;
-	const auto& c_members = cluster.m_members;
-	const auto transmission_rate = disease_profile.GetTransmissionRate();
+	const auto& contact_probabilities = cluster.GetProbabilityTable(1.0);
+	const auto transmission_probability = contact_handler.RateToProbability(disease_profile.GetTransmissionRate());
 
 	// check all contacts
-	for (size_t i_person1 = 0; i_person1 < c_members.size(); i_person1++) {
+	for (size_t i_person1 = 0; i_person1 < cluster.GetSize(); i_person1++) {
 		// check if member is present today
-		if (c_members[i_person1].second) {
-			auto p1 = c_members[i_person1].first;
-			const double contact_rate = cluster.GetContactRate(p1);
+		auto p1 = cluster.GetMember(i_person1);
+		if (p1.IsInCluster(c_type)) {
+			const double contact_probability = contact_probabilities[EffectiveAge(p1.GetAge())];
 
 			// loop over possible contacts
 			// FIXME should this loop start from 0? Because of asymm. contact rates
-			for (size_t i_person2 = i_person1 + 1; i_person2 < c_members.size(); i_person2++) {
+			for (size_t i_person2 = i_person1 + 1; i_person2 < cluster.GetSize(); i_person2++) {
 				// check if member is present today
-				if (c_members[i_person2].second) {
-					auto p2 = c_members[i_person2].first;
+				auto p2 = cluster.GetMember(i_person2);
+				if (p2.IsInCluster(c_type)) {
 
 					// check for contact
-					if (contact_handler.HasContact(contact_rate)) {
+					if (contact_handler.Chance(contact_probability)) {
 						// exchange information about health state & beliefs
-						p1.Update(p2.GetData());
-						p2.Update(p1.GetData());
+						p1.Update(p2);
+						p2.Update(p1);
 
-						bool transmission = contact_handler.HasTransmission(transmission_rate);
+						bool transmission = contact_handler.Chance(transmission_probability);
 						if (transmission) {
 							if (p1.GetHealth().IsInfectious() &&
 							    p2.GetHealth().IsSusceptible()) {
 								LOG_POLICY<log_level>::Execute(
-								    logger, p1, p2, c_type, calendar);
+								    events, p1, p2, c_type, calendar);
 								p2.GetHealth().StartInfection();
 								R0_POLICY<track_index_case>::Execute(p2);
+								RecordInfection(health_changes, new_cases, p2);
 							} else if (
 							    p2.GetHealth().IsInfectious() &&
 							    p1.GetHealth().IsSusceptible()) {
 								LOG_POLICY<log_level>::Execute(
-								    logger, p2, p1, c_type, calendar);
+								    events, p2, p1, c_type, calendar);
 								p1.GetHealth().StartInfection();
 								R0_POLICY<track_index_case>::Execute(p1);
+								RecordInfection(health_changes, new_cases, p1);
 							}
 						}
 					}
@@ -156,44 +165,95 @@ void Infector<log_level, track_index_case, local_information_policy>::Execute(
 //-------------------------------------------------------------------------------------------
 template <LogMode log_level, bool track_index_case>
 void Infector<log_level, track_index_case, NoLocalInformation>::Execute(
-    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& calendar,
-    const std::shared_ptr<spdlog::logger>& logger)
+    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+    std::vector<PersonId>& new_cases, const CalendarRef& calendar, output::EventLog::Writer* events)
 {
-	// check if the cluster has infected members and sort
-	bool infectious_cases;
-	std::size_t num_cases;
-	tie(infectious_cases, num_cases) = cluster.SortMembers();
-
-	if (infectious_cases) {
-		cluster.UpdateMemberPresence();
+	// The cluster keeps its cases (exposed/infected/recovered) in front of its susceptible members,
+	// and its immune members at the back.
+	const auto num_cases = cluster.m_index_susceptible;
 
+	if (num_cases > 0) {
 		// set up some stuff
 		const auto c_type = cluster.m_cluster_type;
 		const auto c_immune = cluster.m_index_immune;
-		const auto& c_members = cluster.m_members;
-		const auto transmission_rate = disease_profile.GetTransmissionRate();
+		const auto& transmission_probabilities =
+		    cluster.GetProbabilityTable(disease_profile.GetTransmissionRate());
+
+		// In large clusters, most contacts do not lead to a transmission: skip straight to the
+		// next one that does instead of testing every contact.
+		if (c_immune - num_cases >= MinSkipSamplingContacts()) {
+			// Collect the potential contacts that are present today.
+			std::vector<std::size_t> contacts;
+			for (size_t i_contact = num_cases; i_contact < c_immune; i_contact++) {
+				if (cluster.GetMember(i_contact).IsInCluster(c_type)) {
+					contacts.push_back(i_contact);
+				}
+			}
+
+			for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
+				// check if member is present today
+				const auto p1 = cluster.GetMember(i_infected);
+				if (p1.IsInCluster(c_type)) {
+					if (p1.GetHealth().IsInfectious()) {
+						const double transmission_probability =
+						    transmission_probabilities[EffectiveAge(p1.GetAge())];
+						size_t i_contact = 0;
+						while (true) {
+							const auto skip =
+							    contact_handler.SkipContactsWithoutTransmission(transmission_probability);
+							if (skip >= contacts.size() - i_contact) {
+								break;
+							}
+							i_contact += skip;
+							auto p2 = cluster.GetMember(contacts[i_contact]);
+							if (p2.GetHealth().IsSusceptible()) {
+								LOG_POLICY<log_level>::Execute(
+								    events, p1, p2, c_type, calendar);
+								p2.GetHealth().StartInfection();
+								R0_POLICY<track_index_case>::Execute(p2);
+								RecordInfection(health_changes, new_cases, p2);
+							}
+							i_contact++;
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		// Count the potential contacts that are present today: every infectious member draws
+		// one batch of random numbers for all of them.
+		size_t num_contacts = 0;
+		for (size_t i_contact = num_cases; i_contact < c_immune; i_contact++) {
+			num_contacts += cluster.GetMember(i_contact).IsInCluster(c_type);
+		}
 
 		// match infectious in first part with susceptible in second part, skip last part (immune)
 		for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
 			// check if member is present today
-			if (c_members[i_infected].second) {
-				const auto p1 = c_members[i_infected].first;
+			const auto p1 = cluster.GetMember(i_infected);
+			if (p1.IsInCluster(c_type)) {
 				// FIXME Is it necessary to check for infectiousness here? Infectious members are
 				// already sorted...
 				if (p1.GetHealth().IsInfectious()) {
-					const double contact_rate = cluster.GetContactRate(p1);
+					const double transmission_probability =
+					    transmission_probabilities[EffectiveAge(p1.GetAge())];
+					const double* chances = contact_handler.NextDoubles(num_contacts);
 					// FIXME if loop 2 in all contacts algorithm should start from 0, we should also
 					// implement this symmetry here!
 					for (size_t i_contact = num_cases; i_contact < c_immune; i_contact++) {
 						// check if member is present today
-						if (c_members[i_contact].second) {
-							auto p2 = c_members[i_contact].first;
-							if (contact_handler.HasContactAndTransmission(
-								contact_rate, transmission_rate)) {
+						auto p2 = cluster.GetMember(i_contact);
+						if (p2.IsInCluster(c_type)) {
+							// People who were infected today in another cluster only move to
+							// the cases after this step, so check before infecting.
+							if (*chances++ < transmission_probability &&
+							    p2.GetHealth().IsSusceptible()) {
 								LOG_POLICY<log_level>::Execute(
-								    logger, p1, p2, c_type, calendar);
+								    events, p1, p2, c_type, calendar);
 								p2.GetHealth().StartInfection();
 								R0_POLICY<track_index_case>::Execute(p2);
+								RecordInfection(health_changes, new_cases, p2);
 							}
 						}
 					}
@@ -208,46 +268,46 @@ void Infector<log_level, track_index_case, NoLocalInformation>::Execute(
 //-------------------------------------------------------------------------------------------
 template <bool track_index_case>
 void Infector<LogMode::Contacts, track_index_case, NoLocalInformation>::Execute(
-    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& calendar,
-    const std::shared_ptr<spdlog::logger>& logger)
+    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+    std::vector<PersonId>& new_cases, const CalendarRef& calendar, output::EventLog::Writer* events)
 {
-	cluster.UpdateMemberPresence();
-
 	// set up some stuff
 	const auto c_type = cluster.m_cluster_type;
-	const auto& c_members = cluster.m_members;
-	const auto transmission_rate = disease_profile.GetTransmissionRate();
+	const auto& contact_probabilities = cluster.GetProbabilityTable(1.0);
+	const auto transmission_probability = contact_handler.RateToProbability(disease_profile.GetTransmissionRate());
 
 	// check all contacts
-	for (size_t i_person1 = 0; i_person1 < c_members.size(); i_person1++) {
+	for (size_t i_person1 = 0; i_person1 < cluster.GetSize(); i_person1++) {
 		// check if member participates in the social contact survey && member is present today
-		if (c_members[i_person1].second && c_members[i_person1].first.IsParticipatingInSurvey()) {
-			auto p1 = c_members[i_person1].first;
-			const double contact_rate = cluster.GetContactRate(p1);
+		auto p1 = cluster.GetMember(i_person1);
+		if (p1.IsInCluster(c_type) && p1.IsParticipatingInSurvey()) {
+			const double contact_probability = contact_probabilities[EffectiveAge(p1.GetAge())];
 			// loop over possible contacts
-			for (size_t i_person2 = i_person1 + 1; i_person2 < c_members.size(); i_person2++) {
+			for (size_t i_person2 = i_person1 + 1; i_person2 < cluster.GetSize(); i_person2++) {
 				// check if member is present today
-				if (c_members[i_person2].second) {
-					auto p2 = c_members[i_person2].first;
+				auto p2 = cluster.GetMember(i_person2);
+				if (p2.IsInCluster(c_type)) {
 					// check for contact
-					if (contact_handler.HasContact(contact_rate)) {
-						bool transmission = contact_handler.HasTransmission(transmission_rate);
+					if (contact_handler.Chance(contact_probability)) {
+						bool transmission = contact_handler.Chance(transmission_probability);
 
 						if (transmission) {
 							if (p1.GetHealth().IsInfectious() &&
 							    p2.GetHealth().IsSusceptible()) {
 								p2.GetHealth().StartInfection();
 								R0_POLICY<track_index_case>::Execute(p2);
+								RecordInfection(health_changes, new_cases, p2);
 							} else if (
 							    p2.GetHealth().IsInfectious() &&
 							    p1.GetHealth().IsSusceptible()) {
 								p1.GetHealth().StartInfection();
 								R0_POLICY<track_index_case>::Execute(p1);
+								RecordInfection(health_changes, new_cases, p1);
 							}
 						}
 
 						LOG_POLICY<LogMode::Contacts>::Execute(
-						    logger, p1, p2, c_type, calendar);
+						    events, p1, p2, c_type, calendar);
 					}
 				}
 			}
@@ -3,16 +3,24 @@
 
 #include "core/DiseaseProfile.h"
 #include "core/LogMode.h"
+#include "output/EventLog.h"
+#include "pop/Person.h"
 
+#include <cstddef>
 #include <memory>
-#include <spdlog/spdlog.h>
+#include <vector>
 
 namespace stride {
 
 class Cluster;
+class HealthCounts;
 class RngHandler;
 class Calendar;
 
+/// The number of potential contacts in a cluster from which on the NoLocalInformation infector
+/// samples only the contacts that lead to a transmission, rather than testing every contact.
+inline constexpr std::size_t MinSkipSamplingContacts() { return 256U; }
+
 /**
  * Actual contacts and transmission in cluster (primary template).
  */
@@ -20,10 +28,12 @@ template <LogMode log_level, bool track_index_case, typename local_information_p
 class Infector
 {
 public:
-	///
+	/// Infects members of the cluster, records the resulting changes in health status in `health_changes` and
+	/// appends the ids of the newly infected members to `new_cases`. Contacts or transmissions are logged to
+	/// `events` (which may be null if the log level is None).
 	static void Execute(
-	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& sim_state,
-	    const std::shared_ptr<spdlog::logger>& logger);
+	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+	    std::vector<PersonId>& new_cases, const CalendarRef& sim_state, output::EventLog::Writer* events);
 };
 
 /**
@@ -33,10 +43,12 @@ template <LogMode log_level, bool track_index_case>
 class Infector<log_level, track_index_case, NoLocalInformation>
 {
 public:
-	///
+	/// Infects members of the cluster, records the resulting changes in health status in `health_changes` and
+	/// appends the ids of the newly infected members to `new_cases`. Contacts or transmissions are logged to
+	/// `events` (which may be null if the log level is None).
 	static void Execute(
-	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& sim_state,
-	    const std::shared_ptr<spdlog::logger>& logger);
+	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+	    std::vector<PersonId>& new_cases, const CalendarRef& sim_state, output::EventLog::Writer* events);
 };
 
 /**
@@ -47,10 +59,12 @@ template <bool track_index_case>
 class Infector<LogMode::Contacts, track_index_case, NoLocalInformation>
 {
 public:
-	///
+	/// Infects members of the cluster, records the resulting changes in health status in `health_changes` and
+	/// appends the ids of the newly infected members to `new_cases`. Contacts or transmissions are logged to
+	/// `events` (which may be null if the log level is None).
 	static void Execute(
-	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, const CalendarRef& calendar,
-	    const std::shared_ptr<spdlog::logger>& logger);
+	    Cluster& cluster, DiseaseProfile disease_profile, RngHandler& contact_handler, HealthCounts& health_changes,
+	    std::vector<PersonId>& new_cases, const CalendarRef& calendar, output::EventLog::Writer* events);
 };
 
 /// Explicit instantiations in cpp file.
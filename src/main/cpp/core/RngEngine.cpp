@@ -0,0 +1,38 @@
+#include "RngEngine.h"
+
+#include <map>
+#include <string>
+#include <boost/algorithm/string.hpp>
+
+namespace {
+
+using stride::RngEngine;
+using boost::to_upper;
+using namespace std;
+
+map<RngEngine, string> g_rng_engine_name{make_pair(RngEngine::Mrg2, "Mrg2"), make_pair(RngEngine::Philox, "Philox"),
+					 make_pair(RngEngine::Null, "Null")};
+
+map<string, RngEngine> g_name_rng_engine{make_pair("MRG2", RngEngine::Mrg2), make_pair("PHILOX", RngEngine::Philox),
+					 make_pair("NULL", RngEngine::Null)};
+}
+
+namespace stride {
+
+string ToString(RngEngine e) { return (g_rng_engine_name.count(e) == 1) ? g_rng_engine_name[e] : "Null"; }
+
+bool IsRngEngine(const string& s)
+{
+	std::string t{s};
+	to_upper(t);
+	return (g_name_rng_engine.count(t) == 1);
+}
+
+RngEngine ToRngEngine(const string& s)
+{
+	std::string t{s};
+	to_upper(t);
+	return (g_name_rng_engine.count(t) == 1) ? g_name_rng_engine[t] : RngEngine::Null;
+}
+
+} // namespace
@@ -0,0 +1,32 @@
+#ifndef RNG_ENGINE_H_INCLUDED
+#define RNG_ENGINE_H_INCLUDED
+
+#include <string>
+
+namespace stride {
+
+/**
+ * Enum specifying the random number engine that the RngHandlers draw from. The simulator
+ * restarts the engine for every cluster on every day:
+ * \li the mrg2 engine from TRNG, seeded with a hash of the cluster and the day
+ * \li the counter-based Philox4x32-10 engine, with one stream per cluster and day.
+ */
+enum class RngEngine
+{
+	Mrg2 = 0U,
+	Philox = 1U,
+	Null
+};
+
+/// Converts a RngEngine value to corresponding name.
+std::string ToString(RngEngine e);
+
+/// Check whether string is name of RngEngine value.
+bool IsRngEngine(const std::string& s);
+
+/// Converts a string with name to RngEngine value.
+RngEngine ToRngEngine(const std::string& s);
+
+} // end_of_namespace
+
+#endif // include-guard
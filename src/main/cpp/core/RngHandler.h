@@ -2,8 +2,17 @@
 #define RNG_HANDLER_H_INCLUDED
 
 #include "math.h"
+#include "core/ClusterType.h"
+#include "core/RngEngine.h"
+#include "util/Philox.h"
 #include "util/Random.h"
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 namespace stride {
 
 /**
@@ -12,33 +21,86 @@ namespace stride {
 class RngHandler
 {
 public:
-	/// Constructor sets the transmission rate and random number generator.
-	RngHandler(unsigned int seed, unsigned int stream_count, unsigned int id) : m_rng(seed)
+	/// Constructor sets the random number engine and its seed. The numbers come from a stream of
+	/// that seed until SetStream selects another one.
+	explicit RngHandler(unsigned int seed, RngEngine engine = RngEngine::Mrg2)
+	    : m_engine(engine), m_seed(seed), m_rng(seed), m_philox(seed, 0)
 	{
-		m_rng.Split(stream_count, id);
 	}
 
-	/// Convert rate into probability
-	double RateToProbability(double rate) { return 1 - exp(-rate); }
+	/// Restarts the numbers at the stream of the given cluster on the given simulation day. The
+	/// numbers that a cluster gets then don't depend on the thread that processes it.
+	void SetStream(unsigned int day, ClusterType type, std::size_t cluster_id)
+	{
+		const std::uint64_t day_and_type =
+		    static_cast<std::uint64_t>(day) * NumOfClusterTypes() + static_cast<unsigned int>(type);
+		const std::uint64_t stream = (day_and_type << 32) | static_cast<std::uint32_t>(cluster_id);
+		if (m_engine == RngEngine::Philox) {
+			m_philox = util::Philox(m_seed, stream);
+		} else {
+			// Philox makes a good hash of the stream to seed mrg2 with.
+			const auto block = util::Philox::Generate(
+			    {{static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32), 0, 0}},
+			    {{m_seed, 0}});
+			m_rng = util::Random((static_cast<unsigned long>(block[1]) << 32) | block[0]);
+		}
+	}
+
+	/// Gets a random double from [0, 1[.
+	double NextDouble() { return m_engine == RngEngine::Philox ? m_philox.NextDouble() : m_rng.NextDouble(); }
 
-	/// Check if two individuals have transmission.
-	bool HasContactAndTransmission(double contact_rate, double transmission_rate)
+	/// Gets `count` random doubles from [0, 1[, in the order in which NextDouble would have
+	/// produced them. The returned buffer is overwritten by the next call.
+	const double* NextDoubles(std::size_t count)
 	{
-		return m_rng.NextDouble() < RateToProbability(transmission_rate * contact_rate);
+		if (m_buffer.size() < count) {
+			m_buffer.resize(count);
+		}
+		if (m_engine == RngEngine::Philox) {
+			m_philox.Fill(m_buffer.data(), count);
+		} else {
+			for (std::size_t i = 0; i < count; i++) {
+				m_buffer[i] = m_rng.NextDouble();
+			}
+		}
+		return m_buffer.data();
 	}
 
-	/// Check if two individuals have contact.
-	bool HasContact(double contact_rate) { return m_rng.NextDouble() < RateToProbability(contact_rate); }
+	/// Convert rate into probability
+	double RateToProbability(double rate) { return 1 - exp(-rate); }
+
+	/// Return true with the given probability.
+	bool Chance(double probability) { return NextDouble() < probability; }
 
-	///
-	bool HasTransmission(double transmission_rate)
+	/// Get the number of contacts without transmission before the next contact with transmission,
+	/// given the probability of transmission for a single contact. Every contact is an independent
+	/// trial, so this number is geometrically distributed.
+	std::size_t SkipContactsWithoutTransmission(double probability)
 	{
-		return m_rng.NextDouble() < RateToProbability(transmission_rate);
+		if (probability <= 0.0) {
+			return std::numeric_limits<std::size_t>::max();
+		}
+		const double skip = std::floor(std::log1p(-NextDouble()) / std::log1p(-probability));
+		return skip < static_cast<double>(std::numeric_limits<std::size_t>::max())
+			   ? static_cast<std::size_t>(skip)
+			   : std::numeric_limits<std::size_t>::max();
 	}
 
 private:
-	/// Random number engine.
+	/// The engine that NextDouble draws from.
+	RngEngine m_engine;
+
+	/// The seed of the streams.
+	unsigned int m_seed;
+
+	/// The mrg2 random number engine.
 	util::Random m_rng;
+
+	/// The Philox random number engine.
+	util::Philox m_philox;
+
+	/// The numbers returned by NextDoubles.
+	std::vector<double> m_buffer;
 };
 
 } // end_of_namespace
@@ -0,0 +1,166 @@
+#include "GeoIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace stride {
+namespace geo {
+
+namespace {
+
+/// Earth's radius in kilometres, as in GeoPosition::Distance.
+const double g_earth_radius = 6371.0;
+
+/// Lower bounds are shrunk by this factor, so rounding can't prune positions that are in range.
+const double g_bound_margin = 1.0 - 1e-9;
+
+/// Converts degrees to radians.
+double ToRadians(double degrees) { return degrees * M_PI / 180.0; }
+
+/// Gets the distance (in kilometres) from the origin to the meridian at the given longitude.
+double DistanceToMeridian(const GeoPosition& origin, double longitude)
+{
+	double delta = std::fmod(std::abs(origin.longitude - longitude), 360.0);
+	if (delta > 180.0) {
+		delta = 360.0 - delta;
+	}
+	if (delta >= 90.0) {
+		// The closest point of the meridian is the nearest pole.
+		return g_earth_radius * ToRadians(90.0 - std::abs(origin.latitude));
+	}
+	return g_earth_radius * std::asin(std::cos(ToRadians(origin.latitude)) * std::sin(ToRadians(delta)));
+}
+
+} // namespace
+
+GeoIndex::GeoIndex(const std::vector<GeoPosition>& positions)
+{
+	m_nodes.reserve(positions.size());
+	for (std::size_t i = 0; i < positions.size(); i++) {
+		m_nodes.push_back({positions[i], i, Axis::Latitude});
+	}
+	Build(0, m_nodes.size());
+}
+
+void GeoIndex::Build(std::size_t begin, std::size_t end)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	// Split along the axis in which the positions are most spread out.
+	double min_latitude = m_nodes[begin].position.latitude;
+	double max_latitude = min_latitude;
+	double min_longitude = m_nodes[begin].position.longitude;
+	double max_longitude = min_longitude;
+	for (std::size_t i = begin + 1; i < end; i++) {
+		const auto& position = m_nodes[i].position;
+		min_latitude = std::min(min_latitude, position.latitude);
+		max_latitude = std::max(max_latitude, position.latitude);
+		min_longitude = std::min(min_longitude, position.longitude);
+		max_longitude = std::max(max_longitude, position.longitude);
+	}
+	const bool is_latitude = max_latitude - min_latitude >= max_longitude - min_longitude;
+	const Axis axis = is_latitude ? Axis::Latitude : Axis::Longitude;
+
+	const std::size_t mid = begin + (end - begin) / 2;
+	const auto first = m_nodes.begin() + begin;
+	std::nth_element(first, m_nodes.begin() + mid, m_nodes.begin() + end, [axis](const Node& a, const Node& b) {
+		return axis == Axis::Latitude ? a.position.latitude < b.position.latitude
+					      : a.position.longitude < b.position.longitude;
+	});
+	m_nodes[mid].axis = axis;
+
+	Build(begin, mid);
+	Build(mid + 1, end);
+}
+
+double GeoIndex::DistanceToSplit(const GeoPosition& origin, const Node& node)
+{
+	if (node.axis == Axis::Latitude) {
+		// The shortest path to another latitude runs along a meridian.
+		return g_bound_margin * g_earth_radius * ToRadians(std::abs(origin.latitude - node.position.latitude));
+	}
+	// A path to the other side crosses either the split's meridian or the antimeridian.
+	return g_bound_margin *
+	       std::min(DistanceToMeridian(origin, node.position.longitude), DistanceToMeridian(origin, 180.0));
+}
+
+bool GeoIndex::IsLowSide(const GeoPosition& origin, const Node& node)
+{
+	return node.axis == Axis::Latitude ? origin.latitude < node.position.latitude
+					   : origin.longitude < node.position.longitude;
+}
+
+std::vector<std::size_t> GeoIndex::FindInRadius(const GeoPosition& origin, double radius) const
+{
+	std::vector<std::size_t> result;
+	FindInRadius(origin, radius, 0, m_nodes.size(), result);
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+void GeoIndex::FindInRadius(
+    const GeoPosition& origin, double radius, std::size_t begin, std::size_t end,
+    std::vector<std::size_t>& result) const
+{
+	if (begin >= end) {
+		return;
+	}
+	const std::size_t mid = begin + (end - begin) / 2;
+	const auto& node = m_nodes[mid];
+	if (node.position.Distance(origin) < radius) {
+		result.push_back(node.index);
+	}
+
+	const bool low_side = IsLowSide(origin, node);
+	FindInRadius(origin, radius, low_side ? begin : mid + 1, low_side ? mid : end, result);
+	if (DistanceToSplit(origin, node) < radius) {
+		FindInRadius(origin, radius, low_side ? mid + 1 : begin, low_side ? end : mid, result);
+	}
+}
+
+std::vector<std::size_t> GeoIndex::FindNearest(const GeoPosition& origin, std::size_t k) const
+{
+	std::vector<Candidate> heap;
+	if (k > 0) {
+		heap.reserve(std::min(k, m_nodes.size()));
+		FindNearest(origin, k, 0, m_nodes.size(), heap);
+	}
+	std::sort_heap(heap.begin(), heap.end());
+
+	std::vector<std::size_t> result;
+	result.reserve(heap.size());
+	for (const auto& candidate : heap) {
+		result.push_back(candidate.second);
+	}
+	return result;
+}
+
+void GeoIndex::FindNearest(
+    const GeoPosition& origin, std::size_t k, std::size_t begin, std::size_t end, std::vector<Candidate>& heap) const
+{
+	if (begin >= end) {
+		return;
+	}
+	const std::size_t mid = begin + (end - begin) / 2;
+	const auto& node = m_nodes[mid];
+	const Candidate candidate{node.position.Distance(origin), node.index};
+	if (heap.size() < k) {
+		heap.push_back(candidate);
+		std::push_heap(heap.begin(), heap.end());
+	} else if (candidate < heap.front()) {
+		std::pop_heap(heap.begin(), heap.end());
+		heap.back() = candidate;
+		std::push_heap(heap.begin(), heap.end());
+	}
+
+	const bool low_side = IsLowSide(origin, node);
+	FindNearest(origin, k, low_side ? begin : mid + 1, low_side ? mid : end, heap);
+	if (heap.size() < k || DistanceToSplit(origin, node) <= heap.front().first) {
+		FindNearest(origin, k, low_side ? mid + 1 : begin, low_side ? end : mid, heap);
+	}
+}
+
+} // namespace
+} // namespace
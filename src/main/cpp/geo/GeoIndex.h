@@ -0,0 +1,84 @@
+#ifndef GEO_GEOINDEX_H_INCLUDED
+#define GEO_GEOINDEX_H_INCLUDED
+
+#include "geo/GeoPosition.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace stride {
+namespace geo {
+
+/**
+ * A static 2-d tree over a list of geodesic positions, for radius and nearest neighbour
+ * queries. Results refer to positions by their index in the list that the index was built
+ * from. Distances are great-circle distances as computed by GeoPosition::Distance; subtrees
+ * are pruned with lower bounds on the distance to the latitude or longitude that splits them.
+ */
+class GeoIndex
+{
+public:
+	/// Creates an empty index.
+	GeoIndex() = default;
+
+	/// Creates an index over the given positions.
+	explicit GeoIndex(const std::vector<GeoPosition>& positions);
+
+	/// Gets the number of positions in the index.
+	std::size_t size() const { return m_nodes.size(); }
+
+	/// Gets the indices of the positions that are less than radius km away from the origin,
+	/// in increasing order.
+	std::vector<std::size_t> FindInRadius(const GeoPosition& origin, double radius) const;
+
+	/// Gets the indices of the (at most) k positions that are closest to the origin, closest first.
+	std::vector<std::size_t> FindNearest(const GeoPosition& origin, std::size_t k) const;
+
+private:
+	/// The axis along which a node splits its subtree.
+	enum class Axis : std::uint8_t
+	{
+		Latitude,
+		Longitude
+	};
+
+	/// A position, the index it was given and the axis along which it splits its subtree.
+	struct Node
+	{
+		GeoPosition position;
+		std::size_t index;
+		Axis axis;
+	};
+
+	/// A distance and the index of the position that is that far away.
+	using Candidate = std::pair<double, std::size_t>;
+
+	/// Turns the nodes in [begin, end[ into a subtree, which is rooted at the middle node.
+	void Build(std::size_t begin, std::size_t end);
+
+	/// Adds the indices of the positions in the subtree [begin, end[ that are in the radius.
+	void FindInRadius(
+	    const GeoPosition& origin, double radius, std::size_t begin, std::size_t end,
+	    std::vector<std::size_t>& result) const;
+
+	/// Updates the heap of the k nearest candidates with the positions in the subtree [begin, end[.
+	void FindNearest(
+	    const GeoPosition& origin, std::size_t k, std::size_t begin, std::size_t end,
+	    std::vector<Candidate>& heap) const;
+
+	/// Gets a lower bound on the distance from the origin to any position on the other side of
+	/// the given node's split.
+	static double DistanceToSplit(const GeoPosition& origin, const Node& node);
+
+	/// Checks if the origin is on the low side (with the nodes before it) of the given node's split.
+	static bool IsLowSide(const GeoPosition& origin, const Node& node);
+
+	std::vector<Node> m_nodes;
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <unordered_set>
+#include <utility>
 #include "multiregion/SimulationManager.h"
 #include "multiregion/Visitor.h"
 #include "sim/Simulator.h"
@@ -43,7 +44,7 @@ public:
 		result.BeforeSimulatorStep(*sim);
 		auto push_data = sim->TimeStep(pull_data);
 		result.AfterSimulatorStep(*sim);
-		communicator.Push(push_data);
+		communicator.Push(std::move(push_data));
 	}
 
 	/// Applies the given aggregation function to this simulation task's population.
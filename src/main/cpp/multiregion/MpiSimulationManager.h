@@ -0,0 +1,216 @@
+#ifndef MULTIREGION_MPI_SIMULATION_MANAGER_H_INCLUDED
+#define MULTIREGION_MPI_SIMULATION_MANAGER_H_INCLUDED
+
+/**
+ * @file
+ * Distributed multi-region data structures for the simulator.
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/request.hpp>
+#include <boost/mpi/status.hpp>
+#include "multiregion/LocalSimulationTask.h"
+#include "multiregion/SequentialSimulationManager.h"
+#include "multiregion/SimulationManager.h"
+#include "multiregion/Visitor.h"
+#include "multiregion/VisitorMessage.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+
+namespace stride {
+namespace multiregion {
+
+/**
+ * A simulation manager that places the regions on the processes of an MPI communicator. Every process only
+ * simulates its own regions, and sends the people that travel to another process' regions as visitor messages.
+ * Regions are placed round-robin by id, so every process must create the same simulations in the same way.
+ */
+template <typename TResult, typename... TInitialResultArgs>
+class MpiSimulationManager final : public SimulationManager<TResult, TInitialResultArgs...>
+{
+private:
+	class MpiTaskCommunicator final
+	{
+	public:
+		MpiTaskCommunicator(RegionId id, MpiSimulationManager<TResult, TInitialResultArgs...>* manager)
+		    : id(id), manager(manager)
+		{
+		}
+
+		SimulationStepInput Pull() { return manager->comm_data.Pull(id); }
+
+		void Push(SimulationStepOutput&& data) { manager->Push(id, std::move(data)); }
+
+	private:
+		RegionId id;
+		MpiSimulationManager<TResult, TInitialResultArgs...>* manager;
+	};
+
+	/// The tag of messages that contain visitors.
+	static constexpr int visitor_message_tag = 1;
+
+	/// Pushes the output of the given task. Regions on this process get it directly, whereas every region on
+	/// another process gets a message, even if nobody travels there, to satisfy its dependency.
+	void Push(RegionId id, SimulationStepOutput&& data)
+	{
+		auto phase = comm_data.GetPhase(id);
+		SimulationStepOutput local_data;
+		std::unordered_set<RegionId> local_dependencies;
+		std::map<RegionId, VisitorMessage> messages;
+		for (const auto& dep : tasks.at(id)->GetConnectedRegions()) {
+			if (IsLocal(dep)) {
+				local_dependencies.insert(dep);
+			} else {
+				messages.emplace(dep, VisitorMessage(id, dep, phase));
+			}
+		}
+		for (auto& outgoing_visitor : data.visitors) {
+			if (IsLocal(outgoing_visitor.visited_region)) {
+				local_data.visitors.push_back(std::move(outgoing_visitor));
+			} else {
+				messages.at(outgoing_visitor.visited_region).AddVisitor(outgoing_visitor);
+			}
+		}
+		for (auto& returning_expatriate : data.expatriates) {
+			if (IsLocal(returning_expatriate.visited_region)) {
+				local_data.expatriates.push_back(std::move(returning_expatriate));
+			} else {
+				messages.at(returning_expatriate.visited_region).AddExpatriate(returning_expatriate);
+			}
+		}
+
+		for (auto& message : messages) {
+			Send(std::move(message.second));
+		}
+		comm_data.Push(id, local_dependencies, local_data);
+	}
+
+	/// Sends the given message to the process of its target region, without waiting for it to arrive.
+	void Send(VisitorMessage&& message)
+	{
+		pending_sends.emplace_back(std::move(message), boost::mpi::request());
+		auto& pending = pending_sends.back();
+		const auto& bytes = pending.first.GetBytes();
+		pending.second = world.isend(
+		    GetRank(pending.first.GetTargetRegion()), visitor_message_tag, bytes.data(),
+		    static_cast<int>(bytes.size()));
+	}
+
+	/// Waits for a message from another process, and pushes it to its target region.
+	void Receive()
+	{
+		auto status = world.probe(boost::mpi::any_source, visitor_message_tag);
+		std::vector<char> bytes(*status.template count<char>());
+		world.recv(status.source(), status.tag(), bytes.data(), static_cast<int>(bytes.size()));
+		VisitorMessage message(std::move(bytes));
+		comm_data.Push(message.GetTargetRegion(), message.GetPhase(), message.ToStepInput());
+	}
+
+	/// Registers the given task, which is ready to perform its first step.
+	void AddTask(RegionId id, const std::shared_ptr<LocalSimulationTask<TResult, MpiTaskCommunicator>>& task)
+	{
+		tasks[id] = task;
+		comm_data.AddTask(id, task->GetConnectedRegions());
+		active_task_count++;
+	}
+
+	boost::mpi::communicator world;
+	TaskCommunicationData comm_data;
+	std::unordered_map<RegionId, std::shared_ptr<LocalSimulationTask<TResult, MpiTaskCommunicator>>> tasks;
+	std::list<std::pair<VisitorMessage, boost::mpi::request>> pending_sends;
+	unsigned int number_of_sim_threads;
+	std::size_t active_task_count;
+
+public:
+	MpiSimulationManager(const boost::mpi::communicator& world, unsigned int number_of_sim_threads)
+	    : world(world), number_of_sim_threads(number_of_sim_threads), active_task_count(0)
+	{
+	}
+
+	/// Gets the rank of the process that simulates the region with the given id.
+	int GetRank(RegionId id) const { return static_cast<int>(id % static_cast<RegionId>(world.size())); }
+
+	/// Tests if the region with the given id is simulated by this process.
+	bool IsLocal(RegionId id) const { return GetRank(id) == world.rank(); }
+
+	/// Creates and initiates a new simulation task based on the given configuration. Returns null if the region
+	/// is simulated by another process.
+	std::shared_ptr<SimulationTask<TResult>> CreateSimulation(
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
+	    TInitialResultArgs... args) final override
+	{
+		auto id = configuration.travel_model->GetRegionId();
+		if (!IsLocal(id)) {
+			return nullptr;
+		}
+
+		// Build a simulator.
+		auto sim = SimulatorBuilder::Build(configuration, log, number_of_sim_threads);
+		auto task = std::make_shared<LocalSimulationTask<TResult, MpiTaskCommunicator>>(
+		    sim, MpiTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
+		AddTask(id, task);
+		return task;
+	}
+
+#if USE_HDF5
+	/// Loads a new simulation task from the Checkpoint. Returns null if the region is simulated by another
+	/// process.
+	std::shared_ptr<SimulationTask<TResult>> LoadSimulation(
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
+	    const std::string& cp, const boost::gregorian::date& date, TInitialResultArgs... args) final override
+	{
+		auto id = configuration.travel_model->GetRegionId();
+		if (!IsLocal(id)) {
+			return nullptr;
+		}
+
+		// Build a simulator.
+		auto sim = SimulatorBuilder::Load(configuration, log, cp, date, number_of_sim_threads);
+		auto task = std::make_shared<LocalSimulationTask<TResult, MpiTaskCommunicator>>(
+		    sim, MpiTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
+		AddTask(id, task);
+		return task;
+	}
+#endif
+
+	/// Waits for all tasks on this process to complete.
+	void WaitAll() final override
+	{
+		while (active_task_count > 0) {
+			RegionId ready_id;
+			if (!comm_data.TryPopReady(ready_id)) {
+				// None of our tasks can proceed until another process sends us its visitors.
+				Receive();
+				continue;
+			}
+
+			auto task = tasks.at(ready_id);
+			if (!task->IsDone()) {
+				task->Step();
+			} else {
+				active_task_count--;
+			}
+			pending_sends.remove_if([](std::pair<VisitorMessage, boost::mpi::request>& pending) {
+				return static_cast<bool>(pending.second.test());
+			});
+		}
+
+		// Our messages must not be destroyed before they have been received.
+		for (auto& pending : pending_sends) {
+			pending.second.wait();
+		}
+		pending_sends.clear();
+	}
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
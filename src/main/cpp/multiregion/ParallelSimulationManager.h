@@ -6,19 +6,191 @@
  * Parallel multi-region data structures for the simulator.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
-#include <spdlog/spdlog.h>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "multiregion/LocalSimulationTask.h"
-#include "multiregion/SequentialSimulationManager.h"
 #include "multiregion/SimulationManager.h"
+#include "multiregion/Visitor.h"
 #include "sim/Simulator.h"
 #include "sim/SimulatorBuilder.h"
 
 namespace stride {
 namespace multiregion {
 
+/**
+ * Defines a communication buffer for a single task that may be accessed by several threads at once. The regions
+ * the task is connected to push messages into its mailbox without taking a lock, and only the task itself pulls
+ * them out again. Every region the task depends on satisfies one dependency per step, as does the task itself,
+ * and whoever satisfies the last dependency of a phase makes the task ready.
+ *
+ * A region can never be more than a single step ahead of the regions it is connected to, so only the dependency
+ * counters of two consecutive phases are in use at any time.
+ */
+class ConcurrentTaskCommunicationBuffer final
+{
+public:
+	/// Creates a buffer for a task that depends on the given number of regions.
+	explicit ConcurrentTaskCommunicationBuffer(std::size_t dependency_count)
+	    : phase(0), dependency_count(dependency_count), mailbox(nullptr)
+	{
+		for (auto& count : unsatisfied_dependencies) {
+			count = dependency_count + 1;
+		}
+	}
+
+	ConcurrentTaskCommunicationBuffer(const ConcurrentTaskCommunicationBuffer&) = delete;
+	ConcurrentTaskCommunicationBuffer& operator=(const ConcurrentTaskCommunicationBuffer&) = delete;
+
+	~ConcurrentTaskCommunicationBuffer()
+	{
+		for (auto message = mailbox.load(); message != nullptr;) {
+			auto next = message->next;
+			delete message;
+			message = next;
+		}
+	}
+
+	/// Gets the communication buffer's phase, i.e., the simulation day that will be pulled next. Must only be
+	/// called by the task that owns this buffer.
+	std::size_t GetPhase() const { return phase; }
+
+	/// Pushes a message from the given region, which is to be pulled in the given phase. Thread-safe.
+	void Push(std::size_t message_phase, RegionId source_region_id, SimulationStepInput&& data)
+	{
+		auto message = new Message{message_phase, source_region_id, std::move(data), mailbox.load()};
+		while (!mailbox.compare_exchange_weak(
+		    message->next, message, std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+
+	/// Satisfies a dependency of the given phase. Returns true if it was the last one, i.e., if the task is now
+	/// ready to pull that phase. Thread-safe.
+	bool SatisfyDependency(std::size_t dependency_phase)
+	{
+		auto& count = unsatisfied_dependencies[dependency_phase % 2];
+		if (count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+			return false;
+		}
+		// Nobody touches this counter again until the task has pulled this phase.
+		count.store(dependency_count + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/// Pulls the data for the current phase from this buffer. Must only be called by the task that owns this
+	/// buffer.
+	SimulationStepInput Pull()
+	{
+		for (auto message = mailbox.exchange(nullptr, std::memory_order_acquire); message != nullptr;) {
+			auto next = message->next;
+			received.emplace_back(message);
+			message = next;
+		}
+
+		// Messages are merged in the order of the regions that sent them, which doesn't depend on the order
+		// in which they arrived.
+		std::sort(received.begin(), received.end(), [](const MessagePtr& a, const MessagePtr& b) {
+			return std::tie(a->phase, a->source_region_id) < std::tie(b->phase, b->source_region_id);
+		});
+		SimulationStepInput result;
+		auto message = received.begin();
+		for (; message != received.end() && (*message)->phase == phase; ++message) {
+			auto& data = (*message)->data;
+			result.visitors.insert(
+			    result.visitors.end(), std::make_move_iterator(data.visitors.begin()),
+			    std::make_move_iterator(data.visitors.end()));
+			result.expatriates.insert(
+			    result.expatriates.end(), std::make_move_iterator(data.expatriates.begin()),
+			    std::make_move_iterator(data.expatriates.end()));
+		}
+		received.erase(received.begin(), message);
+		phase++;
+		return result;
+	}
+
+private:
+	/// A message in the mailbox, which is a lock-free stack.
+	struct Message
+	{
+		std::size_t phase;
+		RegionId source_region_id;
+		SimulationStepInput data;
+		Message* next;
+	};
+
+	using MessagePtr = std::unique_ptr<Message>;
+
+	/// The task's current phase, i.e., the simulation day that will be pulled next.
+	std::size_t phase;
+
+	/// The number of regions the task depends on.
+	const std::size_t dependency_count;
+
+	/// The number of dependencies that have not been satisfied yet, for even and odd phases.
+	std::atomic<std::size_t> unsatisfied_dependencies[2];
+
+	/// The most recently pushed message.
+	std::atomic<Message*> mailbox;
+
+	/// The messages that have been taken out of the mailbox, but not pulled yet.
+	std::vector<MessagePtr> received;
+};
+
+/// A queue of tasks that are ready to perform a step. Threads that pop a task sleep until one is ready.
+class ReadyTaskQueue final
+{
+public:
+	ReadyTaskQueue() : closed(false) {}
+
+	/// Adds a task that is ready.
+	void Push(RegionId id)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			ready_tasks.push(id);
+		}
+		condition.notify_one();
+	}
+
+	/// Waits until a task is ready and pops it. Returns false if the queue is closed.
+	bool Pop(RegionId& id)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this]() { return closed || !ready_tasks.empty(); });
+		if (ready_tasks.empty()) {
+			return false;
+		}
+		id = ready_tasks.front();
+		ready_tasks.pop();
+		return true;
+	}
+
+	/// Closes the queue, which wakes up all threads that are waiting for a task.
+	void Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			closed = true;
+		}
+		condition.notify_all();
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::queue<RegionId> ready_tasks;
+	bool closed;
+};
+
 /**
  * A parallel simulation manager implementation.
  */
@@ -35,38 +207,59 @@ private:
 		{
 		}
 
-		SimulationStepInput Pull()
-		{
-			std::lock_guard<std::mutex> lock(manager->comm_mutex);
-			return manager->comm_data.Pull(id);
-		}
+		SimulationStepInput Pull() { return manager->buffers.at(id)->Pull(); }
 
-		void Push(const SimulationStepOutput& data)
-		{
-			std::lock_guard<std::mutex> lock(manager->comm_mutex);
-			manager->comm_data.Push(id, manager->tasks[id]->GetConnectedRegions(), data);
-		}
+		void Push(SimulationStepOutput&& data) { manager->Push(id, std::move(data)); }
 
 	private:
 		RegionId id;
 		ParallelSimulationManager<TResult, TInitialResultArgs...>* manager;
 	};
 
-	bool TryPopReady(RegionId& id)
+	/// Pushes the output of the given task to the regions it sent people to, and marks the tasks whose
+	/// dependencies are now satisfied as ready.
+	void Push(RegionId id, SimulationStepOutput&& data)
 	{
-		auto success = comm_data.TryPopReady(id);
-		if (success) {
-			comm_data.ResetDependencies(id, tasks[id]->GetConnectedRegions());
+		auto phase = buffers.at(id)->GetPhase();
+		std::unordered_map<RegionId, SimulationStepInput> messages;
+		for (const auto& outgoing_visitor : data.visitors) {
+			messages[outgoing_visitor.visited_region].visitors.emplace_back(
+			    outgoing_visitor.person_id, outgoing_visitor.person, id, outgoing_visitor.return_day);
+		}
+		for (const auto& returning_expatriate : data.expatriates) {
+			messages[returning_expatriate.visited_region].expatriates.emplace_back(
+			    returning_expatriate.person_id, returning_expatriate.person);
+		}
+		for (auto& message : messages) {
+			buffers.at(message.first)->Push(phase, id, std::move(message.second));
+		}
+
+		// The messages must be in place before any of their recipients can become ready.
+		for (const auto& dep : tasks.at(id)->GetConnectedRegions()) {
+			if (buffers.at(dep)->SatisfyDependency(phase)) {
+				ready_tasks.Push(dep);
+			}
+		}
+		if (buffers.at(id)->SatisfyDependency(phase)) {
+			ready_tasks.Push(id);
 		}
-		return success;
 	}
 
-	TaskCommunicationData comm_data;
+	/// Registers the given task, which is ready to perform its first step.
+	void AddTask(RegionId id, const std::shared_ptr<LocalSimulationTask<TResult, ParallelTaskCommunicator>>& task)
+	{
+		tasks[id] = task;
+		buffers[id] = std::make_unique<ConcurrentTaskCommunicationBuffer>(task->GetConnectedRegions().size());
+		ready_tasks.Push(id);
+		active_task_count++;
+	}
+
+	std::unordered_map<RegionId, std::unique_ptr<ConcurrentTaskCommunicationBuffer>> buffers;
 	std::unordered_map<RegionId, std::shared_ptr<LocalSimulationTask<TResult, ParallelTaskCommunicator>>> tasks;
-	std::mutex comm_mutex;
+	ReadyTaskQueue ready_tasks;
 	std::size_t number_of_task_threads;
 	unsigned int number_of_sim_threads;
-	volatile std::size_t active_task_count;
+	std::atomic<std::size_t> active_task_count;
 
 public:
 	ParallelSimulationManager(std::size_t number_of_task_threads, unsigned int number_of_sim_threads)
@@ -77,7 +270,7 @@ public:
 
 	/// Creates and initiates a new simulation task based on the given configuration.
 	std::shared_ptr<SimulationTask<TResult>> CreateSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    TInitialResultArgs... args) final override
 	{
 		// Build a simulator.
@@ -85,16 +278,14 @@ public:
 		auto id = configuration.travel_model->GetRegionId();
 		auto task = std::make_shared<LocalSimulationTask<TResult, ParallelTaskCommunicator>>(
 		    sim, ParallelTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
-		tasks[id] = task;
-		comm_data.MarkReady(id);
-		active_task_count++;
+		AddTask(id, task);
 		return task;
 	}
 
 #if USE_HDF5
 	/// Loads a new simulation task from the Checkpoint.
 	std::shared_ptr<SimulationTask<TResult>> LoadSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    const std::string& cp, const boost::gregorian::date& date, TInitialResultArgs... args) final override
 	{
 		// Build a simulator.
@@ -102,9 +293,7 @@ public:
 		auto id = configuration.travel_model->GetRegionId();
 		auto task = std::make_shared<LocalSimulationTask<TResult, ParallelTaskCommunicator>>(
 		    sim, ParallelTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
-		tasks[id] = task;
-		comm_data.MarkReady(id);
-		active_task_count++;
+		AddTask(id, task);
 		return task;
 	}
 #endif
@@ -112,41 +301,22 @@ public:
 	/// Waits for all tasks to complete.
 	void WaitAll() final override
 	{
-		// Start 'number_of_task_threads' threads.
+		if (active_task_count == 0) {
+			return;
+		}
+
+		// Start 'number_of_task_threads' threads, which sleep while no task is ready.
 		std::vector<std::thread> threads;
 		for (std::size_t i = 0; i < number_of_task_threads; i++) {
 			threads.emplace_back([this]() {
-				// We will leave at least one thread running until the number of active tasks reaches
-				// zero.
-				while (active_task_count > 0) {
-					// Acquire a lock, so we don't get weird race conditions like popping the same
-					// task twice.
-					comm_mutex.lock();
-
-					// Try to pop a task that's ready to perform a time step.
-					RegionId ready_id;
-					if (TryPopReady(ready_id)) {
-						auto task = tasks[ready_id];
-						if (task->IsDone()) {
-							// This task's done. We ought to decrement the active task
-							// counter and we can also consider ending this thread.
-							auto count = --active_task_count;
-							comm_mutex.unlock();
-							if (count < number_of_task_threads) {
-								// End this thread of execution. We don't need it
-								// anymore.
-								break;
-							}
-						} else {
-							// Have the task perform a single step. Release the
-							// communication lock early so other threads can proceed.
-							comm_mutex.unlock();
-							task->Step();
-						}
-					} else {
-						// No task was ready. Free the lock to give the other tasks the
-						// opportunity to push their outputs and try again.
-						comm_mutex.unlock();
+				RegionId ready_id;
+				while (ready_tasks.Pop(ready_id)) {
+					const auto& task = tasks.at(ready_id);
+					if (!task->IsDone()) {
+						task->Step();
+					} else if (--active_task_count == 0) {
+						// This was the last task, so every thread can stop.
+						ready_tasks.Close();
 					}
 				}
 			});
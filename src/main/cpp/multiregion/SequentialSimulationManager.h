@@ -6,10 +6,11 @@
  * Sequential multi-region data structures for the simulator.
  */
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
-#include <spdlog/spdlog.h>
 #include "multiregion/LocalSimulationTask.h"
 #include "multiregion/SimulationManager.h"
 #include "multiregion/Visitor.h"
@@ -24,20 +25,26 @@ class TaskCommunicationBuffer final
 {
 public:
 	/// Tells if this communication buffer is ready for a pull operation by checking if all of its dependencies have
-	/// been satisfied.
-	bool IsReady() const { return unsatisfied_dependencies.size() == 0; }
+	/// been satisfied for its current phase.
+	bool IsReady() const
+	{
+		auto it = satisfied_dependencies.find(phase);
+		return it != satisfied_dependencies.end() && it->second == dependency_count + 1;
+	}
 
 	/// Gets the communication buffer's phase, i.e., the simulation day that will be pulled next.
 	std::size_t GetPhase() const { return phase; }
 
-	/// Satisfied the given dependency.
-	void SatisfyDependency(RegionId dependency) { unsatisfied_dependencies.erase(dependency); }
+	/// Satisfies a dependency of the given phase. The task itself must satisfy one as well, once it has pushed
+	/// its output for that phase.
+	void SatisfyDependency(std::size_t dependency_phase) { satisfied_dependencies[dependency_phase]++; }
 
 	/// Pulls the data from this buffer.
 	SimulationStepInput Pull()
 	{
 		SimulationStepInput result = std::move(pull_buffers[phase]);
 		pull_buffers.erase(phase);
+		satisfied_dependencies.erase(phase);
 		phase++;
 		return result;
 	}
@@ -46,30 +53,39 @@ public:
 	void PushVisitor(std::size_t source_region_phase, RegionId source_region_id, const OutgoingVisitor& visitor)
 	{
 		pull_buffers[source_region_phase].visitors.emplace_back(
-		    visitor.person, source_region_id, visitor.return_day);
+		    visitor.person_id, visitor.person, source_region_id, visitor.return_day);
 	}
 
 	/// Pushes an expatriate from the given region into this buffer.
-	void PushExpatriate(std::size_t source_region_phase, const Person& expatriate)
+	void PushExpatriate(std::size_t source_region_phase, const OutgoingVisitor& expatriate)
 	{
-		pull_buffers[source_region_phase].expatriates.emplace_back(expatriate);
+		pull_buffers[source_region_phase].expatriates.emplace_back(expatriate.person_id, expatriate.person);
 	}
 
-	/// Sets this buffer's dependencies to the given set of dependencies.
-	void ResetDependencies(const std::unordered_set<RegionId>& new_unsatisfied_dependencies)
+	/// Pushes input that was received from another region into this buffer.
+	void PushInput(std::size_t source_region_phase, SimulationStepInput&& input)
 	{
-		unsatisfied_dependencies = new_unsatisfied_dependencies;
+		auto& buffer = pull_buffers[source_region_phase];
+		std::move(input.visitors.begin(), input.visitors.end(), std::back_inserter(buffer.visitors));
+		std::move(input.expatriates.begin(), input.expatriates.end(), std::back_inserter(buffer.expatriates));
 	}
 
+	/// Sets the number of regions this buffer's task depends on.
+	void SetDependencyCount(std::size_t count) { dependency_count = count; }
+
 private:
 	/// The task's next pull result, which is mutable.
 	std::unordered_map<std::size_t, SimulationStepInput> pull_buffers;
 
 	/// The task's current phase, i.e., the simulation day that will be pulled next.
-	std::size_t phase;
+	std::size_t phase = 0;
+
+	/// The number of regions the task depends on.
+	std::size_t dependency_count = 0;
 
-	/// The set of all task dependencies that have not been satisfied yet.
-	std::unordered_set<RegionId> unsatisfied_dependencies;
+	/// The number of dependencies that have been satisfied, per phase. Regions may run a phase ahead of this
+	/// task, so their dependencies are kept until the task pulls that phase.
+	std::unordered_map<std::size_t, std::size_t> satisfied_dependencies;
 };
 
 /// Contains common data for a graph of communicating tasks.
@@ -91,6 +107,16 @@ public:
 	/// Marks the task with the given id as ready.
 	void MarkReady(RegionId id) { ready_tasks.insert(id); }
 
+	/// Registers the task with the given id and dependencies, which is ready to perform its first step.
+	void AddTask(RegionId id, const std::unordered_set<RegionId>& dependencies)
+	{
+		buffers[id].SetDependencyCount(dependencies.size());
+		MarkReady(id);
+	}
+
+	/// Gets the phase of the task with the given id.
+	std::size_t GetPhase(RegionId id) const { return buffers.at(id).GetPhase(); }
+
 	/// Pulls input data for the task with the given id.
 	SimulationStepInput Pull(RegionId id) { return buffers[id].Pull(); }
 
@@ -102,27 +128,34 @@ public:
 			buffers[outgoing_visitor.visited_region].PushVisitor(phase, id, outgoing_visitor);
 		}
 		for (const auto& returning_expatriate : data.expatriates) {
-			buffers[returning_expatriate.visited_region].PushExpatriate(phase, returning_expatriate.person);
+			buffers[returning_expatriate.visited_region].PushExpatriate(phase, returning_expatriate);
 		}
 		for (const auto& dep : dependencies) {
-			auto& buf = buffers[dep];
-			buf.SatisfyDependency(id);
-			if (buf.IsReady()) {
-				MarkReady(dep);
-			}
-		}
-		if (buffers[id].IsReady()) {
-			MarkReady(id);
+			SatisfyDependency(dep, phase);
 		}
+		SatisfyDependency(id, phase);
 	}
 
-	/// Resets the dependencies of the region with the given id.
-	void ResetDependencies(RegionId id, const std::unordered_set<RegionId>& dependencies)
+	/// Pushes input data that was sent to the task with the given id by another region in the given phase,
+	/// and satisfies that region's dependency.
+	void Push(RegionId id, std::size_t phase, SimulationStepInput&& data)
 	{
-		buffers[id].ResetDependencies(dependencies);
+		buffers[id].PushInput(phase, std::move(data));
+		SatisfyDependency(id, phase);
 	}
 
 private:
+	/// Satisfies a dependency of the given phase for the task with the given id, and marks it as ready if that
+	/// was its last one.
+	void SatisfyDependency(RegionId id, std::size_t phase)
+	{
+		auto& buf = buffers[id];
+		buf.SatisfyDependency(phase);
+		if (buf.IsReady()) {
+			MarkReady(id);
+		}
+	}
+
 	std::unordered_set<RegionId> ready_tasks;
 	std::unordered_map<RegionId, TaskCommunicationBuffer> buffers;
 };
@@ -145,7 +178,7 @@ private:
 
 		SimulationStepInput Pull() { return manager->comm_data.Pull(id); }
 
-		void Push(const SimulationStepOutput& data)
+		void Push(SimulationStepOutput&& data)
 		{
 			manager->comm_data.Push(id, manager->tasks[id]->GetConnectedRegions(), data);
 		}
@@ -166,7 +199,7 @@ public:
 
 	/// Creates and initiates a new simulation task based on the given configuration.
 	std::shared_ptr<SimulationTask<TResult>> CreateSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    TInitialResultArgs... args) final override
 	{
 		// Build a simulator.
@@ -175,14 +208,14 @@ public:
 		auto task = std::make_shared<LocalSimulationTask<TResult, SequentialTaskCommunicator>>(
 		    sim, SequentialTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
 		tasks[id] = task;
-		comm_data.MarkReady(id);
+		comm_data.AddTask(id, task->GetConnectedRegions());
 		return task;
 	}
 
 #if USE_HDF5
 	/// Loads a new simulation task from the Checkpoint.
 	std::shared_ptr<SimulationTask<TResult>> LoadSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    const std::string& cp, const boost::gregorian::date& date, TInitialResultArgs... args) final override
 	{
 		// Build a simulator.
@@ -191,7 +224,7 @@ public:
 		auto task = std::make_shared<LocalSimulationTask<TResult, SequentialTaskCommunicator>>(
 		    sim, SequentialTaskCommunicator(id, this), args..., configuration.common_config->generate_vis_file);
 		tasks[id] = task;
-		comm_data.MarkReady(id);
+		comm_data.AddTask(id, task->GetConnectedRegions());
 		return task;
 	}
 #endif
@@ -201,7 +234,6 @@ public:
 	{
 		RegionId ready_id;
 		while (comm_data.TryPopReady(ready_id)) {
-			comm_data.ResetDependencies(ready_id, tasks[ready_id]->GetConnectedRegions());
 			auto task = tasks[ready_id];
 			if (!task->IsDone()) {
 				task->Step();
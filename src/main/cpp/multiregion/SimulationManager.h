@@ -11,6 +11,7 @@
 #include <vector>
 #include <boost/any.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include "output/EventLog.h"
 #include "pop/Population.h"
 #include "sim/SimulationConfig.h"
 
@@ -66,12 +67,12 @@ struct SimulationManager
 {
 	/// Creates a new simulation task based on the given configuration.
 	virtual std::shared_ptr<SimulationTask<TResult>> CreateSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    TInitialResultArgs... args) = 0;
 #if USE_HDF5
 	/// Loads a simulation from the checkpoint
 	virtual std::shared_ptr<SimulationTask<TResult>> LoadSimulation(
-	    const SingleSimulationConfig& configuration, const std::shared_ptr<spdlog::logger>& log,
+	    const SingleSimulationConfig& configuration, const std::shared_ptr<output::EventLog>& log,
 	    const std::string& cp, const boost::gregorian::date& date, TInitialResultArgs... args) = 0;
 #endif
 
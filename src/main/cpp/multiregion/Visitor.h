@@ -1,7 +1,9 @@
 #ifndef VISITOR_H_INCLUDED
 #define VISITOR_H_INCLUDED
 
+#include <utility>
 #include <vector>
+#include "core/Health.h"
 #include "multiregion/TravelModel.h"
 #include "pop/Person.h"
 
@@ -12,18 +14,49 @@
 namespace stride {
 namespace multiregion {
 
+/**
+ * The part of a person's data that travels with them to another region. Everything else, like their clusters,
+ * stays behind in their home region, where they keep their slot while they're abroad.
+ */
+struct TravellerData final
+{
+	/// Copies the travelling part of the given person's data.
+	explicit TravellerData(const Person& person)
+	    : age(person.GetAge()), health(person.GetHealth()), is_participant(person.IsParticipatingInSurvey())
+	{
+	}
+
+	TravellerData(double age, const Health& health, bool is_participant)
+	    : age(age), health(health), is_participant(is_participant)
+	{
+	}
+
+	/// The person's age.
+	double age;
+
+	/// The person's health.
+	Health health;
+
+	/// Does this person participate in the social contact study?
+	bool is_participant;
+};
+
 /**
  * Represents an outgoing visitor: a person who visits another region.
  */
 struct OutgoingVisitor final
 {
-	OutgoingVisitor(const Person& person, RegionId visited_region, std::size_t return_day)
-	    : person(person), visited_region(visited_region), return_day(return_day)
+	OutgoingVisitor(
+	    PersonId person_id, const TravellerData& person, RegionId visited_region, std::size_t return_day)
+	    : person_id(person_id), person(person), visited_region(visited_region), return_day(return_day)
 	{
 	}
 
+	/// The id of the person who is visiting another region, in the region that sends them.
+	PersonId person_id;
+
 	/// The person who is visiting another region.
-	Person person;
+	TravellerData person;
 
 	/// The region this visitor is visiting.
 	RegionId visited_region;
@@ -37,13 +70,16 @@ struct OutgoingVisitor final
  */
 struct IncomingVisitor final
 {
-	IncomingVisitor(const Person& person, RegionId home_region, std::size_t return_day)
-	    : person(person), home_region(home_region), return_day(return_day)
+	IncomingVisitor(PersonId person_id, const TravellerData& person, RegionId home_region, std::size_t return_day)
+	    : person_id(person_id), person(person), home_region(home_region), return_day(return_day)
 	{
 	}
 
+	/// The id of the person who is visiting another region, in the region that sent them.
+	PersonId person_id;
+
 	/// The person who is visiting another region.
-	Person person;
+	TravellerData person;
 
 	/// The region this visitor is visiting from.
 	RegionId home_region;
@@ -52,21 +88,52 @@ struct IncomingVisitor final
 	std::size_t return_day;
 };
 
+/**
+ * Represents an expatriate who returns to their home region.
+ */
+struct ReturningExpatriate final
+{
+	ReturningExpatriate(PersonId person_id, const TravellerData& person) : person_id(person_id), person(person) {}
+
+	/// The expatriate's id in their home region.
+	PersonId person_id;
+
+	/// The expatriate's data, as it was when they left the region they visited.
+	TravellerData person;
+};
+
 /// The input for a single step in the simulation and the result
-/// of a pull operation.
+/// of a pull operation. It can only be moved, so people are never
+/// copied on their way from one region to another.
 struct SimulationStepInput final
 {
+	SimulationStepInput() = default;
+	SimulationStepInput(const SimulationStepInput&) = delete;
+	SimulationStepInput(SimulationStepInput&&) = default;
+	SimulationStepInput& operator=(const SimulationStepInput&) = delete;
+	SimulationStepInput& operator=(SimulationStepInput&&) = default;
+
 	/// The list of all incoming visitors.
 	std::vector<IncomingVisitor> visitors;
 
 	/// The list of all returning expatriates.
-	std::vector<Person> expatriates;
+	std::vector<ReturningExpatriate> expatriates;
 };
 
 /// The output for a single step in the simulation and the result
-/// of a push operation.
+/// of a push operation. It can only be moved, like SimulationStepInput.
 struct SimulationStepOutput final
 {
+	SimulationStepOutput() = default;
+	SimulationStepOutput(std::vector<OutgoingVisitor>&& visitors, std::vector<OutgoingVisitor>&& expatriates)
+	    : visitors(std::move(visitors)), expatriates(std::move(expatriates))
+	{
+	}
+	SimulationStepOutput(const SimulationStepOutput&) = delete;
+	SimulationStepOutput(SimulationStepOutput&&) = default;
+	SimulationStepOutput& operator=(const SimulationStepOutput&) = delete;
+	SimulationStepOutput& operator=(SimulationStepOutput&&) = default;
+
 	/// The list of all outgoing visitors.
 	std::vector<OutgoingVisitor> visitors;
 
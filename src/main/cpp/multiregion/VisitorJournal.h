@@ -37,7 +37,8 @@ struct VisitorId final
 class ExpatriateJournal final
 {
 public:
-	/// Adds an expatriate to this journal.
+	/// Adds an expatriate to this journal. The given person should be detached from their
+	/// population for as long as they're abroad.
 	void AddExpatriate(const Person& person)
 	{
 		if (expatriates.find(person.GetId()) != expatriates.end()) {
@@ -63,7 +64,7 @@ public:
 	/// `action` must be invocable with signature
 	/// `void(const Person& person, unsigned int dummy)`.
 	template <typename TAction>
-	void SerialForeach(const TAction& action)
+	void SerialForeach(const TAction& action) const
 	{
 		for (const auto& pair : expatriates) {
 			action(pair.second, 0);
@@ -71,7 +72,7 @@ public:
 	}
 
 private:
-	/// A dictionary that maps expatriate person ids to personal information.
+	/// A dictionary that maps expatriate person ids to their (detached) persons.
 	std::unordered_map<PersonId, Person> expatriates;
 };
 
@@ -0,0 +1,81 @@
+#include "VisitorMessage.h"
+
+#include <cstring>
+#include <utility>
+#include "core/Health.h"
+#include "util/Errors.h"
+
+namespace stride {
+namespace multiregion {
+
+VisitorMessage::VisitorMessage(RegionId source_region, RegionId target_region, std::size_t phase)
+    : bytes(sizeof(Header))
+{
+	const Header header{source_region, target_region, phase};
+	std::memcpy(bytes.data(), &header, sizeof(Header));
+}
+
+VisitorMessage::VisitorMessage(std::vector<char>&& bytes) : bytes(std::move(bytes))
+{
+	if (this->bytes.size() < sizeof(Header) || (this->bytes.size() - sizeof(Header)) % sizeof(PersonRecord) != 0) {
+		FATAL_ERROR("Visitor message has an invalid size.");
+	}
+}
+
+VisitorMessage::Header VisitorMessage::GetHeader() const
+{
+	Header header;
+	std::memcpy(&header, bytes.data(), sizeof(Header));
+	return header;
+}
+
+void VisitorMessage::AddPerson(const OutgoingVisitor& person, bool is_expatriate)
+{
+	const auto& data = person.person;
+	PersonRecord record{};
+	record.person_id = person.person_id;
+	record.return_day = person.return_day;
+	record.age = data.age;
+	record.start_infectiousness = data.health.GetStartInfectiousness();
+	record.start_symptomatic = data.health.GetStartSymptomatic();
+	record.end_infectiousness = data.health.GetEndInfectiousness();
+	record.end_symptomatic = data.health.GetEndSymptomatic();
+	record.days_infected = data.health.GetDaysInfected();
+	record.health_status = static_cast<std::uint8_t>(ToSizeType(data.health.GetHealthStatus()));
+	record.is_participant = data.is_participant;
+	record.is_expatriate = is_expatriate;
+
+	const auto offset = bytes.size();
+	bytes.resize(offset + sizeof(PersonRecord));
+	std::memcpy(bytes.data() + offset, &record, sizeof(PersonRecord));
+}
+
+SimulationStepInput VisitorMessage::ToStepInput() const
+{
+	const auto source_region = GetSourceRegion();
+	SimulationStepInput result;
+	for (auto offset = sizeof(Header); offset < bytes.size(); offset += sizeof(PersonRecord)) {
+		PersonRecord record;
+		std::memcpy(&record, bytes.data() + offset, sizeof(PersonRecord));
+
+		disease::Fate fate;
+		fate.start_infectiousness = record.start_infectiousness;
+		fate.start_symptomatic = record.start_symptomatic;
+		fate.end_infectiousness = record.end_infectiousness;
+		fate.end_symptomatic = record.end_symptomatic;
+
+		const TravellerData person(
+		    record.age, Health(fate, static_cast<HealthStatus>(record.health_status), record.days_infected),
+		    record.is_participant != 0);
+
+		if (record.is_expatriate) {
+			result.expatriates.emplace_back(record.person_id, person);
+		} else {
+			result.visitors.emplace_back(record.person_id, person, source_region, record.return_day);
+		}
+	}
+	return result;
+}
+
+} // namespace
+} // namespace
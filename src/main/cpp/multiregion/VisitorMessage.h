@@ -0,0 +1,91 @@
+#ifndef VISITOR_MESSAGE_H_INCLUDED
+#define VISITOR_MESSAGE_H_INCLUDED
+
+/**
+ * @file
+ * Defines a compact message format for the people that travel from one region to another.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "multiregion/TravelModel.h"
+#include "multiregion/Visitor.h"
+
+namespace stride {
+namespace multiregion {
+
+/**
+ * The visitors and returning expatriates that one region sends to another region in a single step, stored as a
+ * flat block of bytes that can be sent to another process as is. Both processes must use the same byte order.
+ */
+class VisitorMessage final
+{
+public:
+	/// Creates an empty message from the given region to the given region, for the given phase.
+	VisitorMessage(RegionId source_region, RegionId target_region, std::size_t phase);
+
+	/// Creates a message from the given bytes, which were received from another process.
+	explicit VisitorMessage(std::vector<char>&& bytes);
+
+	/// Gets the region that sent this message.
+	RegionId GetSourceRegion() const { return GetHeader().source_region; }
+
+	/// Gets the region this message is sent to.
+	RegionId GetTargetRegion() const { return GetHeader().target_region; }
+
+	/// Gets the phase in which the target region will pull this message.
+	std::size_t GetPhase() const { return GetHeader().phase; }
+
+	/// Gets this message's bytes.
+	const std::vector<char>& GetBytes() const { return bytes; }
+
+	/// Adds a visitor to this message.
+	void AddVisitor(const OutgoingVisitor& visitor) { AddPerson(visitor, false); }
+
+	/// Adds a returning expatriate to this message.
+	void AddExpatriate(const OutgoingVisitor& expatriate) { AddPerson(expatriate, true); }
+
+	/// Decodes this message's people as the target region's input for a single step.
+	SimulationStepInput ToStepInput() const;
+
+private:
+	struct Header
+	{
+		std::uint64_t source_region;
+		std::uint64_t target_region;
+		std::uint64_t phase;
+	};
+
+	/// A single person and their health.
+	struct PersonRecord
+	{
+		std::uint32_t person_id;
+		std::uint32_t return_day;
+		double age;
+		std::uint32_t start_infectiousness;
+		std::uint32_t start_symptomatic;
+		std::uint32_t end_infectiousness;
+		std::uint32_t end_symptomatic;
+		std::uint32_t days_infected;
+		std::uint8_t health_status;
+		std::uint8_t is_participant;
+		std::uint8_t is_expatriate;
+		std::uint8_t padding;
+	};
+
+	static_assert(sizeof(PersonRecord) == 40, "Person records must not contain any implicit padding.");
+
+	/// Gets this message's header.
+	Header GetHeader() const;
+
+	/// Appends the given person to this message.
+	void AddPerson(const OutgoingVisitor& person, bool is_expatriate);
+
+	std::vector<char> bytes;
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
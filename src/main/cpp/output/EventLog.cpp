@@ -0,0 +1,219 @@
+#include "EventLog.h"
+
+#include "util/Errors.h"
+
+#include <cstring>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace stride {
+namespace output {
+
+using namespace std;
+
+namespace {
+
+/// The header of an event log file.
+struct FileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t record_size;
+};
+
+const char g_magic[8] = {'S', 'T', 'R', 'I', 'D', 'E', 'E', 'V'};
+
+/// The headers of the CSV files that an event log is converted to.
+const char g_participants_header[] = "local_id,part_age,part_gender";
+const char g_contacts_header[] =
+    "local_id,part_age,cnt_age,cnt_home,cnt_school,cnt_work,cnt_prim_comm,cnt_sec_comm,sim_day";
+const char g_transmissions_header[] = "local_id,new_infected_id,cnt_location,sim_day";
+
+/// Opens the CSV file <prefix><suffix> and writes its header, unless the file is open already.
+std::ofstream& OpenCsv(std::ofstream& file, const std::string& prefix, const char* suffix, const char* header)
+{
+	if (!file.is_open()) {
+		const auto path = prefix + suffix;
+		file.open(path);
+		if (!file.is_open()) {
+			FATAL_ERROR("Error opening file " + path);
+		}
+		file << header << "\n";
+	}
+	return file;
+}
+
+} // namespace
+
+constexpr std::uint32_t EventLog::g_version;
+constexpr std::size_t EventLog::g_block_size;
+
+EventLog::Writer::Writer() { m_records.reserve(g_block_size); }
+
+void EventLog::Writer::Seal()
+{
+	if (m_records.empty()) {
+		return;
+	}
+	const auto records = reinterpret_cast<const char*>(m_records.data());
+	const std::size_t raw_size = m_records.size() * sizeof(EventRecord);
+
+	BlockHeader header{Codec::Raw, static_cast<std::uint32_t>(m_records.size()), raw_size};
+	const std::size_t offset = m_blocks.size();
+#ifdef USE_ZLIB
+	uLongf payload_size = compressBound(raw_size);
+	m_blocks.resize(offset + sizeof(BlockHeader) + payload_size);
+	const auto status = compress2(
+	    reinterpret_cast<Bytef*>(&m_blocks[offset + sizeof(BlockHeader)]), &payload_size,
+	    reinterpret_cast<const Bytef*>(records), raw_size, Z_BEST_SPEED);
+	if (status != Z_OK) {
+		FATAL_ERROR("Error compressing events.");
+	}
+	header.codec = Codec::Deflate;
+	header.payload_size = payload_size;
+	m_blocks.resize(offset + sizeof(BlockHeader) + payload_size);
+#else
+	m_blocks.resize(offset + sizeof(BlockHeader) + raw_size);
+	std::memcpy(&m_blocks[offset + sizeof(BlockHeader)], records, raw_size);
+#endif
+	std::memcpy(&m_blocks[offset], &header, sizeof(BlockHeader));
+	m_records.clear();
+}
+
+EventLog::EventLog(const std::string& path) : m_file(path, ios::binary | ios::trunc), m_path(path)
+{
+	if (!m_file.is_open()) {
+		FATAL_ERROR("Error opening file " + path);
+	}
+	FileHeader header;
+	std::memcpy(header.magic, g_magic, sizeof(g_magic));
+	header.version = g_version;
+	header.record_size = sizeof(EventRecord);
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+	ReserveWriters(1);
+}
+
+EventLog::~EventLog() { Close(); }
+
+void EventLog::ReserveWriters(unsigned int count)
+{
+	while (m_writers.size() < count) {
+		m_writers.push_back(std::make_unique<Writer>());
+	}
+}
+
+void EventLog::Flush()
+{
+	for (auto& writer : m_writers) {
+		m_file.write(writer->m_blocks.data(), writer->m_blocks.size());
+		writer->m_blocks.clear();
+	}
+	if (!m_file) {
+		FATAL_ERROR("Error writing file " + m_path);
+	}
+}
+
+void EventLog::Close()
+{
+	if (!m_file.is_open()) {
+		return;
+	}
+	for (auto& writer : m_writers) {
+		writer->Seal();
+	}
+	Flush();
+	m_file.close();
+}
+
+EventLogReader::EventLogReader(const std::string& path) : m_file(path, ios::binary), m_path(path)
+{
+	if (!m_file.is_open()) {
+		FATAL_ERROR("Error opening file " + path);
+	}
+	FileHeader header;
+	m_file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
+	if (!m_file || std::memcmp(header.magic, g_magic, sizeof(g_magic)) != 0) {
+		FATAL_ERROR("File " + path + " is not an event log.");
+	}
+	if (header.version != EventLog::g_version || header.record_size != sizeof(EventRecord)) {
+		FATAL_ERROR("Event log " + path + " has an unsupported version.");
+	}
+}
+
+bool EventLogReader::ReadBlock(std::vector<EventRecord>& records)
+{
+	EventLog::BlockHeader header;
+	if (!m_file.read(reinterpret_cast<char*>(&header), sizeof(EventLog::BlockHeader))) {
+		return false;
+	}
+	m_payload.resize(header.payload_size);
+	if (!m_file.read(m_payload.data(), header.payload_size)) {
+		FATAL_ERROR("Event log " + m_path + " is truncated.");
+	}
+
+	records.resize(header.record_count);
+	const std::size_t raw_size = records.size() * sizeof(EventRecord);
+	if (header.codec == EventLog::Codec::Raw) {
+		if (header.payload_size != raw_size) {
+			FATAL_ERROR("Event log " + m_path + " has a corrupt block.");
+		}
+		std::memcpy(records.data(), m_payload.data(), raw_size);
+	} else if (header.codec == EventLog::Codec::Deflate) {
+#ifdef USE_ZLIB
+		uLongf size = raw_size;
+		const auto status = uncompress(
+		    reinterpret_cast<Bytef*>(records.data()), &size, reinterpret_cast<const Bytef*>(m_payload.data()),
+		    m_payload.size());
+		if (status != Z_OK || size != raw_size) {
+			FATAL_ERROR("Event log " + m_path + " has a corrupt block.");
+		}
+#else
+		FATAL_ERROR("Event log " + m_path + " is compressed, but Stride was built without zlib.");
+#endif
+	} else {
+		FATAL_ERROR("Event log " + m_path + " has a block with an unknown codec.");
+	}
+	return true;
+}
+
+void WriteEventCsvFiles(const std::string& log_path, const std::string& output_prefix)
+{
+	EventLogReader reader(log_path);
+
+	// The participants file is always created, the others only when the first event of their kind is read.
+	std::ofstream participants;
+	std::ofstream contacts;
+	std::ofstream transmissions;
+	OpenCsv(participants, output_prefix, "_participants.csv", g_participants_header);
+	std::vector<EventRecord> records;
+	while (reader.ReadBlock(records)) {
+		for (const auto& e : records) {
+			switch (e.kind) {
+			case EventKind::Participant:
+				OpenCsv(participants, output_prefix, "_participants.csv", g_participants_header)
+				    << e.person_id << "," << e.person_age << "," << e.gender << "\n";
+				break;
+			case EventKind::Contact:
+				OpenCsv(contacts, output_prefix, "_contacts.csv", g_contacts_header)
+				    << e.person_id << "," << e.person_age << "," << e.other_age;
+				for (unsigned int i = 0; i < NumOfClusterTypes(); i++) {
+					contacts << "," << (e.cluster_type == i ? 1 : 0);
+				}
+				contacts << "," << e.day << "\n";
+				break;
+			case EventKind::Transmission:
+				OpenCsv(transmissions, output_prefix, "_transmissions.csv", g_transmissions_header)
+				    << e.person_id << "," << e.other_id << "," << ToString(e.GetClusterType()) << ","
+				    << e.day << "\n";
+				break;
+			default:
+				FATAL_ERROR("Event log " + log_path + " contains an event of an unknown kind.");
+			}
+		}
+	}
+}
+
+} // end_of_namespace
+} // end_of_namespace
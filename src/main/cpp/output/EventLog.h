@@ -0,0 +1,172 @@
+#ifndef EVENT_LOG_H_INCLUDED
+#define EVENT_LOG_H_INCLUDED
+
+#include "core/ClusterType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace output {
+
+/// Enumerates the kinds of events that are logged.
+enum class EventKind : std::uint8_t
+{
+	Participant,
+	Contact,
+	Transmission
+};
+
+/**
+ * A single logged event, stored as a fixed-size record.
+ */
+struct EventRecord
+{
+	/// The simulation day on which the event happened.
+	std::uint32_t day;
+
+	/// The participant, the person who made a contact or the person who transmitted the disease.
+	std::uint32_t person_id;
+
+	/// The contacted or the newly infected person.
+	std::uint32_t other_id;
+
+	float person_age;
+	float other_age;
+
+	EventKind kind;
+
+	/// The type of cluster in which the contact or transmission happened.
+	std::uint8_t cluster_type;
+
+	/// The gender of a participant.
+	char gender;
+
+	std::uint8_t padding;
+
+	/// Gets the cluster type.
+	ClusterType GetClusterType() const { return static_cast<ClusterType>(cluster_type); }
+};
+
+static_assert(sizeof(EventRecord) == 24, "Event records must not contain any implicit padding.");
+
+/**
+ * A binary log of events. Every thread appends events to its own writer, without taking any
+ * locks. A writer compresses its events into blocks (with zlib, if available) as soon as it has
+ * a full block of them, and the blocks are written to the file by Flush, which must only be
+ * called while no thread is appending events. The file starts with a header (magic, format
+ * version and record size), followed by blocks that each start with a BlockHeader.
+ */
+class EventLog
+{
+public:
+	/// The version of the format that is written, and the only version that can be read.
+	static constexpr std::uint32_t g_version = 1;
+
+	/// The (maximum) number of records in a block.
+	static constexpr std::size_t g_block_size = 1U << 14;
+
+	/// The encodings of the records in a block.
+	enum class Codec : std::uint32_t
+	{
+		Raw,
+		Deflate
+	};
+
+	/// Precedes the (compressed) records in a block.
+	struct BlockHeader
+	{
+		Codec codec;
+		std::uint32_t record_count;
+		std::uint64_t payload_size;
+	};
+
+	/// Collects the events of a single thread.
+	class Writer
+	{
+	public:
+		/// Creates an empty writer.
+		Writer();
+
+		/// Appends the given event.
+		void Append(const EventRecord& record)
+		{
+			m_records.push_back(record);
+			if (m_records.size() == g_block_size) {
+				Seal();
+			}
+		}
+
+	private:
+		friend class EventLog;
+
+		/// Compresses the collected events into a block that is ready to be written.
+		void Seal();
+
+		/// The events that have not been sealed yet (never more than g_block_size).
+		std::vector<EventRecord> m_records;
+
+		/// The sealed blocks, which have not been written yet.
+		std::vector<char> m_blocks;
+	};
+
+	/// Creates a log that is written to the file at the given path, with a single writer.
+	explicit EventLog(const std::string& path);
+
+	EventLog(const EventLog&) = delete;
+	EventLog& operator=(const EventLog&) = delete;
+
+	/// Closes the log.
+	~EventLog();
+
+	/// Makes sure that there are writers with ids up to (but not including) the given count.
+	/// Must not be called while any thread is appending events.
+	void ReserveWriters(unsigned int count);
+
+	/// Gets the writer with the given id.
+	Writer& GetWriter(unsigned int id) { return *m_writers[id]; }
+
+	/// Writes the sealed blocks of every writer to the file. Must not be called while any thread
+	/// is appending events.
+	void Flush();
+
+	/// Seals and writes all remaining events, and closes the file.
+	void Close();
+
+private:
+	std::ofstream m_file;
+	std::string m_path;
+	std::vector<std::unique_ptr<Writer>> m_writers;
+};
+
+/**
+ * Reads an event log block by block.
+ */
+class EventLogReader
+{
+public:
+	/// Opens the event log at the given path. Throws a fatal error if it isn't a valid event log.
+	explicit EventLogReader(const std::string& path);
+
+	/// Replaces the given records with the ones in the next block. Returns false at the end of the log.
+	bool ReadBlock(std::vector<EventRecord>& records);
+
+private:
+	std::ifstream m_file;
+	std::string m_path;
+	std::vector<char> m_payload;
+};
+
+/// Converts the event log at the given path to the files <output_prefix>_participants.csv,
+/// <output_prefix>_contacts.csv and <output_prefix>_transmissions.csv. The participants file is always
+/// created; the others are only created if the log contains events of their kind.
+void WriteEventCsvFiles(const std::string& log_path, const std::string& output_prefix);
+
+} // end_of_namespace
+} // end_of_namespace
+
+#endif // end of include guard
@@ -0,0 +1,61 @@
+#include "output/EventLog.h"
+#include "util/Stopwatch.h"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <boost/algorithm/string/predicate.hpp>
+#include <tclap/CmdLine.h>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace TCLAP;
+
+/// Main program of the strideevents program, which converts an event log to CSV files.
+int main(int argc, char** argv)
+{
+	int exit_status = EXIT_SUCCESS;
+	try {
+		// -----------------------------------------------------------------------------------------
+		// Parse command line.
+		// -----------------------------------------------------------------------------------------
+		CmdLine cmd("strideevents", ' ', "1.0", false);
+
+		ValueArg<string> output_prefix(
+		    "o", "output", "The prefix of the CSV files to write (defaults to the input file without _events.bin)",
+		    false, "", "PREFIX", cmd);
+
+		UnlabeledValueArg<string> input_file("input", "The event log to convert", true, "", "EVENT LOG", cmd);
+
+		cmd.parse(argc, argv);
+
+		const string suffix = "_events.bin";
+		string prefix = output_prefix.getValue();
+		if (prefix.empty()) {
+			prefix = input_file.getValue();
+			if (boost::algorithm::ends_with(prefix, suffix)) {
+				prefix.resize(prefix.size() - suffix.size());
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------
+		// Convert.
+		// -----------------------------------------------------------------------------------------
+		Stopwatch<> clock("clock", true);
+		output::WriteEventCsvFiles(input_file.getValue(), prefix);
+		clock.Stop();
+
+		cout << "Converted " << input_file.getValue() << " to " << prefix << "_*.csv in " << clock.ToString()
+		     << endl;
+
+	} catch (exception& e) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: " << e.what() << endl;
+	} catch (...) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: "
+		     << "Unknown exception." << endl;
+	}
+	return exit_status;
+}
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <map>
 #include <memory>
 #include <numeric>
@@ -259,50 +260,121 @@ Population Generator::Generate()
 		Debug("Created {} secondary communities.", secondary_communities_created);
 	}
 
-	// Generate people.
+	// Generate people. The households are partitioned by location into contiguous ranges with
+	// roughly the same number of people, which are assigned in parallel. Every partition has its
+	// own random stream, so the population only depends on the seed and the number of threads.
 	{
 		Debug("Generating people...");
-		HouseholdClusterId household_id = 1;
-		ClusterId person_id = 1;
-
+		using HouseholdIterator = std::map<GeoPosition, std::vector<ReferenceHousehold>>::const_iterator;
+
+		/// A range of household locations, and the first household and person id in it.
+		struct Partition
+		{
+			unsigned int index;
+			HouseholdIterator first;
+			HouseholdIterator last;
+			HouseholdClusterId household_id;
+			std::size_t person_id;
+		};
+
+		/// The attributes of a generated person, before they are added to the population.
+		struct PersonRecord
+		{
+			int age;
+			HouseholdClusterId household_id;
+			int school_id;
+			int work_id;
+			int primary_community_id;
+			int secondary_community_id;
+			disease::Fate fate;
+		};
+
+		std::size_t num_people = 0;
 		for (const auto& p : households) {
-			const auto& home = p.first;
 			for (const auto& rh : p.second) {
-				for (const int age : rh.ages) {
-					int school_id = 0;
-					int work_id = 0;
-					if (model->IsSchoolAge(age)) {
-						school_id = random.Sample(random.Sample(FindLocal(home, schools)));
-					} else if (model->IsCollegeAge(age)) {
-						bool commutes = random.Chance(model->college_commute_ratio);
-						school_id = random.Sample(
-						    commutes ? colleges[college_brng.Next()]
-							     : FindLocal(home, colleges));
-					} else if (
-					    model->IsEmployableAge(age) && random.Chance(model->employed_ratio)) {
-						// TODO: technically, commuters should commute to workplaces in big
-						// cities, not just random ones.
-						bool commutes = random.Chance(model->work_commute_ratio);
-						work_id = random.Sample(
-						    FindLocal(commutes ? work_geo_brng.Next() : home, workplaces));
-					}
+				num_people += rh.ages.size();
+			}
+		}
 
-					int primary_community_id = random.Sample(FindLocal(home, primary_communities));
-					int secondary_community_id =
-					    random.Sample(FindLocal(home, secondary_communities));
+		// Start a new partition whenever the previous ones hold their share of the people.
+		const unsigned int num_partitions = util::parallel::get_number_of_threads();
+		std::vector<Partition> partitions;
+		{
+			HouseholdClusterId household_id = 1;
+			std::size_t person_id = 1;
+			for (auto it = households.cbegin(); it != households.cend(); ++it) {
+				if ((person_id - 1) * num_partitions >= num_people * partitions.size()) {
+					if (!partitions.empty()) {
+						partitions.back().last = it;
+					}
+					const auto index = static_cast<unsigned int>(partitions.size());
+					partitions.push_back({index, it, households.cend(), household_id, person_id});
+				}
+				for (const auto& rh : it->second) {
+					person_id += rh.ages.size();
+				}
+				household_id += it->second.size();
+			}
+		}
 
-					population.emplace(
-					    person_id++, age, household_id, school_id, work_id, primary_community_id,
-					    secondary_community_id, disease.Sample(random));
+		// Index the locations of the clusters that people are assigned to.
+		const LocalIndex<std::vector<School>> school_index(schools);
+		const LocalIndex<College> college_index(colleges);
+		const LocalIndex<std::vector<WorkClusterId>> workplace_index(workplaces);
+		const LocalIndex<std::vector<CommunityClusterId>> primary_community_index(primary_communities);
+		const LocalIndex<std::vector<CommunityClusterId>> secondary_community_index(secondary_communities);
+
+		// Picks the clusters and the fate of a person of the given age and household.
+		const auto generate_person = [&](const GeoPosition& home, HouseholdClusterId household_id, int age,
+						 util::Random& rng) {
+			PersonRecord person{age, household_id, 0, 0, 0, 0, {}};
+			if (model->IsSchoolAge(age)) {
+				person.school_id = rng.Sample(rng.Sample(FindLocal(home, school_index, rng)));
+			} else if (model->IsCollegeAge(age)) {
+				bool commutes = rng.Chance(model->college_commute_ratio);
+				person.school_id = rng.Sample(commutes ? colleges.at(college_brng.Next(rng))
+								       : FindLocal(home, college_index, rng));
+			} else if (model->IsEmployableAge(age) && rng.Chance(model->employed_ratio)) {
+				// TODO: technically, commuters should commute to workplaces in big
+				// cities, not just random ones.
+				bool commutes = rng.Chance(model->work_commute_ratio);
+				const auto& origin = commutes ? work_geo_brng.Next(rng) : home;
+				person.work_id = rng.Sample(FindLocal(origin, workplace_index, rng));
+			}
 
-					if (person_id % 10000 == 0) {
-						Debug("Person {}...", person_id);
+			person.primary_community_id = rng.Sample(FindLocal(home, primary_community_index, rng));
+			person.secondary_community_id = rng.Sample(FindLocal(home, secondary_community_index, rng));
+			person.fate = disease.Sample(rng);
+			return person;
+		};
+
+		const unsigned int seed = random(std::numeric_limits<unsigned int>::max());
+		std::vector<PersonRecord> people(num_people);
+		util::parallel::parallel_for(partitions, num_partitions, [&](const Partition& partition, unsigned int) {
+			util::Random rng(seed);
+			rng.Split(num_partitions, partition.index);
+
+			HouseholdClusterId household_id = partition.household_id;
+			std::size_t index = partition.person_id - 1;
+			for (auto it = partition.first; it != partition.last; ++it) {
+				const auto& home = it->first;
+				for (const auto& rh : it->second) {
+					for (const int age : rh.ages) {
+						people[index++] = generate_person(home, household_id, age, rng);
 					}
+					household_id++;
 				}
-				household_id++;
 			}
+		});
+
+		population.reserve(num_people + 1);
+		for (std::size_t i = 0; i < num_people; i++) {
+			const auto& person = people[i];
+			population.emplace(
+			    static_cast<PersonId>(i + 1), person.age, person.household_id, person.school_id,
+			    person.work_id, person.primary_community_id, person.secondary_community_id, person.fate);
 		}
-		Debug("Generated {} people.", person_id - 1);
+		Debug("Generated {} people in {} partitions.", num_people, partitions.size());
 	}
 
 	// Store all the cluster's locations in the population's atlas.
@@ -15,11 +15,13 @@
 #include "Person.h"
 #include "alias/Alias.h"
 #include "core/Disease.h"
+#include "geo/GeoIndex.h"
 #include "geo/Profile.h"
 #include "pop/Population.h"
 #include "sim/SimulationConfig.h"
 #include "util/InclusiveRange.h"
 #include "util/Random.h"
+#include <spdlog/spdlog.h>
 
 namespace stride {
 namespace population {
@@ -57,7 +59,7 @@ public:
 			return;
 		auto console = spdlog::get("popgen");
 		if (!console) {
-			console = spdlog::stderr_logger_st("popgen");
+			console = spdlog::stderr_logger_mt("popgen");
 			console->set_level(spdlog::level::debug);
 			console->set_pattern("\x1b[36;1m[popgen] %v\x1b[0m");
 		}
@@ -87,33 +89,47 @@ private:
 	/// Generate a random GeoPosition in the simulation area.
 	geo::GeoPosition GetRandomGeoPosition() { return geo_profile->GetRandomGeoPosition(random); }
 
-	/// Find a random GeoPosition map value close to the given origin point.
+	/// The values of a map from GeoPositions, with a spatial index over their positions.
 	template <typename T>
-	T& FindLocal(const geo::GeoPosition& origin, std::map<geo::GeoPosition, T>& map, int tries = 5)
+	struct LocalIndex
 	{
-		if (map.empty()) {
+		explicit LocalIndex(const std::map<geo::GeoPosition, T>& map)
+		{
+			for (const auto& p : map) {
+				positions.push_back(p.first);
+				values.push_back(&p.second);
+			}
+			index = geo::GeoIndex(positions);
+		}
+
+		std::vector<geo::GeoPosition> positions;
+		std::vector<const T*> values;
+		geo::GeoIndex index;
+	};
+
+	/// Find a random GeoPosition map value close to the given origin point, using the given random
+	/// number generator (so that it can be called from several threads at once).
+	template <typename T>
+	const T& FindLocal(const geo::GeoPosition& origin, const LocalIndex<T>& local, util::Random& rng, int tries = 5)
+	{
+		if (local.values.empty()) {
 			FATAL_ERROR("Generator::FindLocal called on empty map.");
 		}
 
 		double r = model->search_radius;
-		std::vector<std::reference_wrapper<T>> hits;
 		for (int i = 0; i < tries; i++, r *= 2.0) {
-			for (auto& p : map) {
-				if (p.first.Distance(origin) < r) {
-					hits.emplace_back(p.second);
-				}
-			}
+			const auto hits = local.index.FindInRadius(origin, r);
 			if (!hits.empty()) {
-				return random.Sample(hits).get();
+				return *local.values[rng.Sample(hits)];
 			}
 		}
 
 		Debug("FindLocal: giving up after {} radius expansions", tries);
-		auto it = map.begin();
-		std::advance(it, random(map.size()));
-		const double distance = it->first.Distance(origin);
-		Debug("Settling on distance {} between {} and {}", distance, it->first.ToString(), origin.ToString());
-		return it->second;
+		const auto i = rng(local.values.size());
+		const auto& position = local.positions[i];
+		Debug("Settling on distance {} between {} and {}", position.Distance(origin), position.ToString(),
+		      origin.ToString());
+		return *local.values[i];
 	}
 };
 
@@ -4,6 +4,7 @@
 #include "core/ClusterType.h"
 #include "util/Errors.h"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -13,111 +14,218 @@ namespace stride {
 using namespace std;
 
 template <class BehaviourPolicy, class BeliefPolicy>
-unsigned int& GenericPersonData<BehaviourPolicy, BeliefPolicy>::GetClusterId(ClusterType cluster_type)
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Grow(PersonId id)
 {
-	switch (cluster_type) {
-	case ClusterType::Household:
-		return m_household_id;
-	case ClusterType::School:
-		return m_school_id;
-	case ClusterType::Work:
-		return m_work_id;
-	case ClusterType::PrimaryCommunity:
-		return m_primary_community_id;
-	case ClusterType::SecondaryCommunity:
-		return m_secondary_community_id;
-	default:
-		FATAL_ERROR("Should not reach default.");
+	if (id < m_slots.size()) {
+		return;
 	}
+
+	// Grow geometrically, so repeatedly adding people is amortized constant time.
+	if (id >= m_slots.capacity()) {
+		Reserve(std::max<std::size_t>(id + 1, 2 * m_slots.capacity()));
+	}
+	const std::size_t size = id + 1;
+	m_slots.resize(size, Slot::Vacant);
+	m_present_index.resize(size);
+	m_age.resize(size);
+	m_gender.resize(size);
+	for (auto& column : m_cluster_ids) {
+		column.resize(size);
+	}
+	for (auto& column : m_cluster_indices) {
+		column.resize(size);
+	}
+	m_presence.resize(size);
+	m_health.resize(size, Health(disease::Fate()));
+	m_belief_data.resize(size);
+	m_is_participant.resize(size);
+}
+
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::AddPresent(PersonId id)
+{
+	m_present_index[id] = static_cast<PersonId>(m_present_ids.size());
+	m_present_ids.push_back(id);
 }
 
 template <class BehaviourPolicy, class BeliefPolicy>
-unsigned int GenericPersonData<BehaviourPolicy, BeliefPolicy>::GetClusterId(ClusterType cluster_type) const
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::RemovePresent(PersonId id)
 {
-	switch (cluster_type) {
-	case ClusterType::Household:
-		return m_household_id;
-	case ClusterType::School:
-		return m_school_id;
-	case ClusterType::Work:
-		return m_work_id;
-	case ClusterType::PrimaryCommunity:
-		return m_primary_community_id;
-	case ClusterType::SecondaryCommunity:
-		return m_secondary_community_id;
-	default:
-		FATAL_ERROR("Should not reach default.");
+	const auto index = m_present_index[id];
+	const auto last_id = m_present_ids.back();
+	m_present_ids[index] = last_id;
+	m_present_index[last_id] = index;
+	m_present_ids.pop_back();
+}
+
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Reserve(std::size_t capacity)
+{
+	m_slots.reserve(capacity);
+	m_present_ids.reserve(capacity);
+	m_present_index.reserve(capacity);
+	m_age.reserve(capacity);
+	m_gender.reserve(capacity);
+	for (auto& column : m_cluster_ids) {
+		column.reserve(capacity);
 	}
+	for (auto& column : m_cluster_indices) {
+		column.reserve(capacity);
+	}
+	m_presence.reserve(capacity);
+	m_health.reserve(capacity);
+	m_belief_data.reserve(capacity);
+	m_is_participant.reserve(capacity);
 }
 
 template <class BehaviourPolicy, class BeliefPolicy>
-bool GenericPersonData<BehaviourPolicy, BeliefPolicy>::IsInCluster(ClusterType c) const
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Emplace(PersonId id, const PersonData& data)
 {
-	switch (c) {
-	case ClusterType::Household:
-		return m_at_household;
-	case ClusterType::School:
-		return m_at_school;
-	case ClusterType::Work:
-		return m_at_work;
-	case ClusterType::PrimaryCommunity:
-		return m_at_primary_community;
-	case ClusterType::SecondaryCommunity:
-		return m_at_secondary_community;
-	default:
-		FATAL_ERROR("Should not reach default.");
+	Grow(id);
+	if (m_slots[id] != Slot::Vacant) {
+		FATAL_ERROR("Person id " + to_string(id) + " is already in use.");
+	}
+
+	m_slots[id] = Slot::Present;
+	AddPresent(id);
+	m_age[id] = data.m_age;
+	m_gender[id] = data.m_gender;
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		m_cluster_ids[i][id] = data.m_cluster_ids[i];
 	}
+	// Present in every cluster until the first presence update.
+	m_presence[id] = static_cast<std::uint8_t>((1U << NumOfClusterTypes()) - 1);
+	m_health[id] = data.m_health;
+	m_belief_data[id] = data.m_belief_data;
+	m_is_participant[id] = data.m_is_participant;
+	m_health_counts.Add(data.m_health.GetHealthStatus());
 }
 
 template <class BehaviourPolicy, class BeliefPolicy>
-void GenericPersonData<BehaviourPolicy, BeliefPolicy>::Update(
-    bool is_work_off, bool is_school_off, double fraction_infected)
+typename GenericPersonStore<BehaviourPolicy, BeliefPolicy>::PersonData
+GenericPersonStore<BehaviourPolicy, BeliefPolicy>::GetData(PersonId id) const
 {
-	m_health.Update();
+	PersonData result(m_age[id], 0, 0, 0, 0, 0, disease::Fate());
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		result.m_cluster_ids[i] = m_cluster_ids[i][id];
+	}
+	result.m_gender = m_gender[id];
+	result.m_health = m_health[id];
+	result.m_belief_data = m_belief_data[id];
+	result.m_is_participant = m_is_participant[id] != 0;
+	return result;
+}
 
-	// Vaccination behavior. TODO: multiple behaviors
-	/* if (BehaviorPolicy::PracticesBehavior(BeliefPolicy::BelievesIn(m_belief_data))) {
-		m_health.SetImmune();
-	} */
+template <class BehaviourPolicy, class BeliefPolicy>
+typename GenericPersonStore<BehaviourPolicy, BeliefPolicy>::PersonData
+GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Extract(PersonId id)
+{
+	if (!IsPresent(id)) {
+		FATAL_ERROR("Cannot extract person " + to_string(id) + ": they are not present.");
+	}
+	auto result = GetData(id);
+	Remove(id);
+	return result;
+}
 
-	// Update presence in clusters.
-	if (is_work_off || (m_age <= MinAdultAge() && is_school_off)) {
-		m_at_school = false;
-		m_at_work = false;
-		m_at_secondary_community = false;
-		m_at_primary_community = true;
-	} else {
-		m_at_school = true;
-		m_at_work = true;
-		m_at_secondary_community = true;
-		m_at_primary_community = false;
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Remove(PersonId id)
+{
+	if (!IsPresent(id)) {
+		FATAL_ERROR("Cannot remove person " + to_string(id) + ": they are not present.");
 	}
+	m_slots[id] = Slot::Vacant;
+	RemovePresent(id);
+	m_health_counts.Remove(m_health[id].GetHealthStatus());
+}
 
-	BeliefPolicy::Update(m_belief_data, m_health);
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Detach(PersonId id)
+{
+	if (!IsPresent(id)) {
+		FATAL_ERROR("Cannot detach person " + to_string(id) + ": they are not present.");
+	}
+	m_slots[id] = Slot::Detached;
+	RemovePresent(id);
+	m_health_counts.Remove(m_health[id].GetHealthStatus());
 }
 
 template <class BehaviourPolicy, class BeliefPolicy>
-void GenericPersonData<BehaviourPolicy, BeliefPolicy>::Update(std::shared_ptr<const GenericPersonData> p)
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Attach(PersonId id)
 {
-	BeliefPolicy::Update(m_belief_data, p);
+	if (!IsDetached(id)) {
+		FATAL_ERROR("Cannot attach person " + to_string(id) + ": they are not detached.");
+	}
+	m_slots[id] = Slot::Present;
+	AddPresent(id);
+	m_health_counts.Add(m_health[id].GetHealthStatus());
 }
 
-/// Creates a copy of this person and gives it the given id.
 template <class BehaviourPolicy, class BeliefPolicy>
-GenericPerson<BehaviourPolicy, BeliefPolicy> GenericPerson<BehaviourPolicy, BeliefPolicy>::WithId(PersonId new_id) const
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::SetHealth(PersonId id, const Health& health)
 {
-	auto result = Clone();
-	result.m_id = new_id;
-	return result;
+	if (IsPresent(id)) {
+		m_health_counts.Move(m_health[id].GetHealthStatus(), health.GetHealthStatus());
+	}
+	m_health[id] = health;
+}
+
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::CountHealth()
+{
+	m_health_counts.Clear();
+	for (PersonId id = 0; id < m_slots.size(); id++) {
+		if (m_slots[id] == Slot::Present) {
+			m_health_counts.Add(m_health[id].GetHealthStatus());
+		}
+	}
+}
+
+template <class BehaviourPolicy, class BeliefPolicy>
+bool GenericPersonStore<BehaviourPolicy, BeliefPolicy>::Update(PersonId id, unsigned int days)
+{
+	Health& health = m_health[id];
+	const bool was_infectious = health.IsInfectious();
+	health.Update(days);
+
+	// Vaccination behavior. TODO: multiple behaviors
+	/* if (BehaviorPolicy::PracticesBehavior(BeliefPolicy::BelievesIn(m_belief_data))) {
+		m_health.SetImmune();
+	} */
+
+	BeliefPolicy::Update(m_belief_data[id], health);
+	return health.IsInfectious() != was_infectious;
+}
+
+template <class BehaviourPolicy, class BeliefPolicy>
+void GenericPersonStore<BehaviourPolicy, BeliefPolicy>::UpdatePresence(bool is_work_off, bool is_school_off)
+{
+	// People who are off stay in their primary community, the others go to school or work
+	// and their secondary community. Everyone is always in their household.
+	const std::uint8_t day_off = PresenceMask(ClusterType::Household) | PresenceMask(ClusterType::PrimaryCommunity);
+	const std::uint8_t day_on = PresenceMask(ClusterType::Household) | PresenceMask(ClusterType::School) |
+				    PresenceMask(ClusterType::Work) | PresenceMask(ClusterType::SecondaryCommunity);
+
+	if (is_work_off || !is_school_off) {
+		std::fill(m_presence.begin(), m_presence.end(), is_work_off ? day_off : day_on);
+	} else {
+		// Only children are off: this loop has no branches, so it can be vectorized.
+		const std::size_t size = m_presence.size();
+		const std::uint8_t* age = m_age.data();
+		std::uint8_t* presence = m_presence.data();
+		for (std::size_t id = 0; id < size; id++) {
+			presence[id] = age[id] <= MinAdultAge() ? day_off : day_on;
+		}
+	}
 }
 
 //--------------------------------------------------------------------------
 // All explicit instantiations.
 //--------------------------------------------------------------------------
-template class GenericPersonData<NoBehaviour, NoBelief>;
-template class GenericPersonData<AlwaysFollowBeliefs, Threshold<true, false>>;
-template class GenericPersonData<AlwaysFollowBeliefs, Threshold<false, true>>;
-template class GenericPersonData<AlwaysFollowBeliefs, Threshold<true, true>>;
+template class GenericPersonStore<NoBehaviour, NoBelief>;
+template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<true, false>>;
+template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<false, true>>;
+template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<true, true>>;
 template class GenericPerson<NoBehaviour, NoBelief>;
 template class GenericPerson<AlwaysFollowBeliefs, Threshold<true, false>>;
 template class GenericPerson<AlwaysFollowBeliefs, Threshold<false, true>>;
@@ -1,12 +1,20 @@
 #ifndef PERSON_H_INCLUDED
 #define PERSON_H_INCLUDED
 
+#include "core/ClusterType.h"
 #include "core/Disease.h"
 #include "core/Health.h"
+#include "core/HealthCounts.h"
+#include "util/Errors.h"
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "behaviour/behaviour_policies/AlwaysFollowBeliefs.h"
 #include "behaviour/behaviour_policies/NoBehaviour.h"
@@ -18,11 +26,22 @@ namespace stride {
 
 using PersonId = unsigned int;
 
+/// Gets the bit that marks a person's presence in their cluster of the given type.
+inline constexpr std::uint8_t PresenceMask(ClusterType c) { return static_cast<std::uint8_t>(1U << ToSizeType(c)); }
+
+static_assert(NumOfClusterTypes() <= 8, "Presence in every cluster type must fit in a single byte.");
+
 class Calendar;
-enum class ClusterType;
+
+template <class BehaviourPolicy, class BeliefPolicy>
+class GenericPersonStore;
+
+template <class BehaviourPolicy, class BeliefPolicy>
+class GenericPerson;
 
 /**
- * Store and handle person data.
+ * A copy of a single person's data that is not tied to any population. This is
+ * used to create people and to move them from one population to another.
  */
 template <class BehaviourPolicy, class BeliefPolicy>
 class GenericPersonData
@@ -33,22 +52,21 @@ public:
 	    double age, unsigned int household_id, unsigned int school_id, unsigned int work_id,
 	    unsigned int primary_community_id, unsigned int secondary_community_id, disease::Fate fate,
 	    double risk_averseness = 0)
-	    : m_age(age), m_gender('M'), m_household_id(household_id), m_school_id(school_id), m_work_id(work_id),
-	      m_primary_community_id(primary_community_id), m_secondary_community_id(secondary_community_id),
-	      m_at_household(true), m_at_school(true), m_at_work(true), m_at_primary_community(true),
-	      m_at_secondary_community(true), m_health(fate), m_is_participant(false)
+	    : m_age(ToWholeYears(age)), m_gender('M'), m_is_participant(false),
+	      m_cluster_ids{{household_id, school_id, work_id, primary_community_id, secondary_community_id}},
+	      m_health(fate)
 	{
 		BeliefPolicy::Initialize(m_belief_data, risk_averseness);
 	}
 
-	/// Get the age.
-	double GetAge() const { return m_age; }
+	/// Get the age, in whole years.
+	unsigned int GetAge() const { return m_age; }
 
 	/// Get cluster ID of cluster_type
-	unsigned int GetClusterId(ClusterType cluster_type) const;
+	unsigned int GetClusterId(ClusterType cluster_type) const { return m_cluster_ids[ToSizeType(cluster_type)]; }
 
 	/// Get cluster ID of cluster_type
-	unsigned int& GetClusterId(ClusterType cluster_type);
+	unsigned int& GetClusterId(ClusterType cluster_type) { return m_cluster_ids[ToSizeType(cluster_type)]; }
 
 	/// Return person's gender.
 	char GetGender() const { return m_gender; }
@@ -62,76 +80,211 @@ public:
 	/// Return person's belief status.
 	const typename BeliefPolicy::Data& GetBeliefData() const { return m_belief_data; }
 
-	/// Check if a person is present today in a given cluster
-	bool IsInCluster(ClusterType c) const;
-
 	/// Does this person participates in the social contact study?
 	bool IsParticipatingInSurvey() const { return m_is_participant; }
 
 	/// Participate in social contact study and log person details
 	void ParticipateInSurvey() { m_is_participant = true; }
 
-	/// Update the health status and presence in clusters.
-	void Update(bool is_work_off, bool is_school_off, double fraction_infected);
+private:
+	template <class, class>
+	friend class GenericPersonStore;
 
-	/// Update belief & behaviour upon meeting another Person
-	void Update(std::shared_ptr<const GenericPersonData> p);
+	/// Converts an age to whole years, which are stored in a single byte.
+	static std::uint8_t ToWholeYears(double age)
+	{
+		if (!(age >= 0 && age <= std::numeric_limits<std::uint8_t>::max())) {
+			FATAL_ERROR("Age " + std::to_string(age) + " is out of range.");
+		}
+		return static_cast<std::uint8_t>(age);
+	}
 
-private:
-	double m_age;
+	// The members are ordered from small to large, to keep the padding to a minimum.
+	std::uint8_t m_age;
 	char m_gender;
 
+	/// Is this person participating in the social contact study?
+	bool m_is_participant;
+
+	/// Info about this Person's health beliefs.
+	typename BeliefPolicy::Data m_belief_data;
+
 	/// Which communities does this person belong to?
-	unsigned int m_household_id;
-	unsigned int m_school_id;
-	unsigned int m_work_id;
-	unsigned int m_primary_community_id;
-	unsigned int m_secondary_community_id;
-
-	/// Which of those communities are they present at today?
-	bool m_at_household;
-	bool m_at_school;
-	bool m_at_work;
-	bool m_at_primary_community;
-	bool m_at_secondary_community;
+	std::array<unsigned int, NumOfClusterTypes()> m_cluster_ids;
 
 	/// Health info for this person.
 	Health m_health;
+};
 
-	/// Info about this Person's health beliefs.
-	typename BeliefPolicy::Data m_belief_data;
+static_assert(sizeof(unsigned int) == 4, "Cluster ids should be 32 bits wide.");
+static_assert(
+    sizeof(GenericPersonData<NoBehaviour, NoBelief>) <= 32, "A person without beliefs should fit in 32 bytes.");
 
-	/// Is this person participating in the social contact study?
-	bool m_is_participant;
+/**
+ * Stores the data of many people as a structure of arrays: every attribute is kept in
+ * its own contiguous column, indexed by person id. A slot is either vacant, occupied
+ * by a person who is present in the population or occupied by a person who is
+ * detached from it (e.g., because they're abroad).
+ */
+template <class BehaviourPolicy, class BeliefPolicy>
+class GenericPersonStore
+{
+public:
+	using PersonData = GenericPersonData<BehaviourPolicy, BeliefPolicy>;
+
+	/// Gets the number of slots in this store. All person ids are smaller than this value.
+	std::size_t GetCapacity() const { return m_slots.size(); }
+
+	/// Gets the number of people that are present in this store.
+	std::size_t GetSize() const { return m_present_ids.size(); }
+
+	/// Gets the id of the present person at the given index, which is smaller than GetSize(). Indices
+	/// are not stable: detaching or removing someone moves the last present person into their index.
+	PersonId GetPresentId(std::size_t index) const { return m_present_ids[index]; }
+
+	/// Tests if the person with the given id is present.
+	bool IsPresent(PersonId id) const { return id < m_slots.size() && m_slots[id] == Slot::Present; }
+
+	/// Tests if the person with the given id is detached.
+	bool IsDetached(PersonId id) const { return id < m_slots.size() && m_slots[id] == Slot::Detached; }
+
+	/// Stores the given data in the (vacant) slot for the given id and marks it as present.
+	void Emplace(PersonId id, const PersonData& data);
+
+	/// Copies the data of the person with the given id out of this store.
+	PersonData GetData(PersonId id) const;
+
+	/// Copies the data of the person with the given id out of this store and vacates their slot.
+	PersonData Extract(PersonId id);
+
+	/// Vacates the slot of the person with the given id.
+	void Remove(PersonId id);
+
+	/// Keeps the data of the person with the given id, but stops counting them as present.
+	void Detach(PersonId id);
+
+	/// Marks the detached person with the given id as present again.
+	void Attach(PersonId id);
+
+	/// Reserves room for people with ids up to (but not including) the given capacity.
+	void Reserve(std::size_t capacity);
+
+	/// Get the age.
+	unsigned int GetAge(PersonId id) const { return m_age[id]; }
+
+	/// Get cluster ID of cluster_type
+	unsigned int& GetClusterId(PersonId id, ClusterType cluster_type)
+	{
+		return m_cluster_ids[ToSizeType(cluster_type)][id];
+	}
+
+	/// Gets the index of the person with the given id in the member list of their cluster of the
+	/// given type. Only meaningful while they're a member of that cluster.
+	unsigned int& GetClusterIndex(PersonId id, ClusterType cluster_type)
+	{
+		return m_cluster_indices[ToSizeType(cluster_type)][id];
+	}
+
+	/// Return person's gender.
+	char GetGender(PersonId id) const { return m_gender[id]; }
+
+	/// Return person's health status.
+	Health& GetHealth(PersonId id) { return m_health[id]; }
+
+	/// Replaces a person's health status, and keeps the health counts up to date.
+	void SetHealth(PersonId id, const Health& health);
+
+	/// Gets the number of present people per health status. Code that changes people's health
+	/// through GetHealth must report the changes with AddHealthChanges, or call CountHealth.
+	const HealthCounts& GetHealthCounts() const { return m_health_counts; }
+
+	/// Adds the given changes to the health counts.
+	void AddHealthChanges(const HealthCounts& changes) { m_health_counts += changes; }
+
+	/// Recomputes the health counts from scratch.
+	void CountHealth();
+
+	/// Return person's belief status.
+	typename BeliefPolicy::Data& GetBeliefData(PersonId id) { return m_belief_data[id]; }
+
+	/// Check if a person is present today in a given cluster
+	bool IsInCluster(PersonId id, ClusterType c) const { return (m_presence[id] & PresenceMask(c)) != 0; }
+
+	/// Does this person participates in the social contact study?
+	bool IsParticipatingInSurvey(PersonId id) const { return m_is_participant[id] != 0; }
+
+	/// Participate in social contact study and log person details
+	void ParticipateInSurvey(PersonId id) { m_is_participant[id] = 1; }
+
+	/// Update the health status over the given number of days (see Health::Update). Returns true
+	/// if the person became infectious or stopped being infectious.
+	bool Update(PersonId id, unsigned int days);
+
+	/// Update everyone's presence in their clusters for a day, in a single pass.
+	void UpdatePresence(bool is_work_off, bool is_school_off);
+
+private:
+	/// The state of a slot in the store.
+	enum class Slot : std::uint8_t
+	{
+		Vacant,
+		Present,
+		Detached
+	};
+
+	/// Grows all columns so that the given id fits.
+	void Grow(PersonId id);
+
+	/// Adds the given id to the dense list of present people.
+	void AddPresent(PersonId id);
+
+	/// Swaps the given id out of the dense list of present people.
+	void RemovePresent(PersonId id);
+
+	std::vector<Slot> m_slots;
+
+	/// The ids of all present people, in no particular order, for O(1) access by index.
+	std::vector<PersonId> m_present_ids;
+
+	/// Every present person's index in m_present_ids.
+	std::vector<PersonId> m_present_index;
+
+	std::vector<std::uint8_t> m_age;
+	std::vector<char> m_gender;
+	std::array<std::vector<unsigned int>, NumOfClusterTypes()> m_cluster_ids;
+
+	/// Everyone's index in the member list of their cluster of each type, so clusters can remove
+	/// members in constant time.
+	std::array<std::vector<unsigned int>, NumOfClusterTypes()> m_cluster_indices;
+
+	/// Which of their clusters are they present at today? One PresenceMask bit per cluster type.
+	std::vector<std::uint8_t> m_presence;
+
+	std::vector<Health> m_health;
+	std::vector<typename BeliefPolicy::Data> m_belief_data;
+	std::vector<std::uint8_t> m_is_participant;
+
+	/// The number of present people per health status.
+	HealthCounts m_health_counts;
 };
 
-extern template class GenericPersonData<NoBehaviour, NoBelief>;
-extern template class GenericPersonData<AlwaysFollowBeliefs, Threshold<true, false>>;
-extern template class GenericPersonData<AlwaysFollowBeliefs, Threshold<false, true>>;
-extern template class GenericPersonData<AlwaysFollowBeliefs, Threshold<true, true>>;
+extern template class GenericPersonStore<NoBehaviour, NoBelief>;
+extern template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<true, false>>;
+extern template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<false, true>>;
+extern template class GenericPersonStore<AlwaysFollowBeliefs, Threshold<true, true>>;
 
 /**
- * Describes a person: personal data tagged by an id.
+ * Describes a person: a lightweight handle that refers to a person id in a person store.
  */
 template <class BehaviourPolicy, class BeliefPolicy>
 class GenericPerson
 {
 public:
 	using PersonData = GenericPersonData<BehaviourPolicy, BeliefPolicy>;
-	/// Creates a person from the given information.
-	GenericPerson(
-	    PersonId id, double age, unsigned int household_id, unsigned int school_id, unsigned int work_id,
-	    unsigned int primary_community_id, unsigned int secondary_community_id, disease::Fate fate,
-	    double risk_averseness = 0)
-	    : m_id(id), m_data(
-			    std::make_shared<PersonData>(
-				age, household_id, school_id, work_id, primary_community_id, secondary_community_id,
-				fate, risk_averseness))
-	{
-	}
+	using PersonStore = GenericPersonStore<BehaviourPolicy, BeliefPolicy>;
 
-	/// Creates a person from the given id and data.
-	GenericPerson(PersonId id, const std::shared_ptr<PersonData>& data) : m_id(id), m_data(data) {}
+	/// Creates a handle for the person with the given id in the given store.
+	GenericPerson(PersonStore* store, PersonId id) : m_store(store), m_id(id) {}
 
 	/// Checks if this person is equal to the given person.
 	bool operator==(const GenericPerson& p) const { return m_id == p.m_id; }
@@ -139,54 +292,52 @@ public:
 	/// Checks if this person is not equal to the given person.
 	bool operator!=(const GenericPerson& p) const { return !(*this == p); }
 
-	/// Get the age.
-	double GetAge() const { return m_data->GetAge(); }
+	/// Get the age, in whole years.
+	unsigned int GetAge() const { return m_store->GetAge(m_id); }
 
 	/// Get cluster ID of cluster_type
-	unsigned int& GetClusterId(ClusterType cluster_type) const { return m_data->GetClusterId(cluster_type); }
+	unsigned int& GetClusterId(ClusterType cluster_type) const { return m_store->GetClusterId(m_id, cluster_type); }
 
 	/// Return person's gender.
-	char GetGender() const { return m_data->GetGender(); }
+	char GetGender() const { return m_store->GetGender(m_id); }
 
 	/// Return person's health status.
-	Health& GetHealth() const { return m_data->GetHealth(); }
+	Health& GetHealth() const { return m_store->GetHealth(m_id); }
+
+	/// Replaces the person's health status, and keeps the health counts up to date.
+	void SetHealth(const Health& health) const { m_store->SetHealth(m_id, health); }
 
 	/// Return person's belief status.
-	const typename BeliefPolicy::Data& GetBeliefData() const { return m_data->GetBeliefData(); }
+	const typename BeliefPolicy::Data& GetBeliefData() const { return m_store->GetBeliefData(m_id); }
 
 	/// Get the id.
 	PersonId GetId() const { return m_id; }
 
-	/// Creates a deep copy of this person, including its data.
-	GenericPerson Clone() const { return GenericPerson(m_id, std::make_shared<PersonData>(*m_data)); }
+	/// Gets the store this person lives in.
+	PersonStore* GetStore() const { return m_store; }
 
-	/// Creates a deep copy of this person and gives it the given id.
-	GenericPerson WithId(PersonId new_id) const;
+	/// Copies this person's data out of the store.
+	PersonData GetData() const { return m_store->GetData(m_id); }
 
 	/// Check if a person is present today in a given cluster
-	bool IsInCluster(ClusterType c) const { return m_data->IsInCluster(c); }
+	bool IsInCluster(ClusterType c) const { return m_store->IsInCluster(m_id, c); }
 
 	/// Does this person participates in the social contact study?
-	bool IsParticipatingInSurvey() const { return m_data->IsParticipatingInSurvey(); }
+	bool IsParticipatingInSurvey() const { return m_store->IsParticipatingInSurvey(m_id); }
 
 	/// Participate in social contact study and log person details
-	void ParticipateInSurvey() const { m_data->ParticipateInSurvey(); }
+	void ParticipateInSurvey() const { m_store->ParticipateInSurvey(m_id); }
 
-	/// Update the health status and presence in clusters.
-	void Update(bool is_work_off, bool is_school_off, double fraction_infected) const
-	{
-		m_data->Update(is_work_off, is_school_off, fraction_infected);
-	}
+	/// Update the health status over the given number of days (see Health::Update). Returns true
+	/// if the person became infectious or stopped being infectious.
+	bool Update(unsigned int days) const { return m_store->Update(m_id, days); }
 
 	/// Update belief & behaviour upon meeting another Person
-	void Update(std::shared_ptr<const PersonData> p) const { m_data->Update(p); }
-
-	/// Gets the data that backs this person.
-	std::shared_ptr<PersonData> GetData() const { return m_data; }
+	void Update(const GenericPerson& p) const { BeliefPolicy::Update(m_store->GetBeliefData(m_id), p); }
 
 private:
+	PersonStore* m_store;
 	PersonId m_id;
-	std::shared_ptr<PersonData> m_data;
 };
 
 extern template class GenericPerson<NoBehaviour, NoBelief>;
@@ -196,6 +347,7 @@ extern template class GenericPerson<AlwaysFollowBeliefs, Threshold<true, true>>;
 
 // TODO: Where does this belong; here or Simulator?
 using PersonData = GenericPersonData<NoBehaviour, NoBelief>;
+using PersonStore = GenericPersonStore<NoBehaviour, NoBelief>;
 using Person = GenericPerson<NoBehaviour, NoBelief>;
 
 } // end_of_namespace
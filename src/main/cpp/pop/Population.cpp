@@ -1,6 +1,5 @@
 #include "Population.h"
 
-#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -13,7 +12,6 @@
 #include "core/Health.h"
 #include "util/Errors.h"
 #include "util/Parallel.h"
-#include "util/ParallelMap.h"
 #include "util/Random.h"
 
 namespace stride {
@@ -26,25 +24,31 @@ std::vector<Person> Population::get_random_persons(util::Random& rng, std::size_
 		    std::to_string(size()) + ".");
 	}
 
-	auto max_population_index = size() - 1;
-	std::unordered_map<std::size_t, std::size_t> random_pick_indices;
-	for (std::size_t i = 0; i < count; i++) {
-		std::size_t pick_index;
-		do {
-			pick_index = rng(max_population_index);
-		} while (random_pick_indices.find(pick_index) != random_pick_indices.end());
-		random_pick_indices[pick_index] = i;
-	}
-
-	std::vector<Person> random_picks(count, Person(0, nullptr));
-	std::size_t i = 0;
-	for (const auto& pair : people) {
-		if (random_pick_indices.find(i) != random_pick_indices.end()) {
-			random_picks[random_pick_indices[i]] = Person(pair.first, pair.second);
+	// The store gives us constant-time access to the present people by index, so we only
+	// need to pick 'count' distinct indices.
+	std::vector<Person> random_picks;
+	random_picks.reserve(count);
+	const auto population_size = static_cast<unsigned int>(size());
+	if (2 * count <= size()) {
+		// Few picks: draw indices until we have enough distinct ones. Every draw is new with
+		// a probability of at least one half, so this takes O(count) draws on average.
+		std::unordered_set<std::size_t> random_pick_indices;
+		random_pick_indices.reserve(count);
+		while (random_picks.size() < count) {
+			std::size_t pick_index = rng(population_size);
+			if (random_pick_indices.insert(pick_index).second) {
+				random_picks.emplace_back(people.get(), people->GetPresentId(pick_index));
+			}
+		}
+	} else {
+		// Many picks: a partial Fisher-Yates shuffle of all indices.
+		std::vector<std::size_t> indices(size());
+		std::iota(indices.begin(), indices.end(), 0);
+		for (std::size_t i = 0; i < count; i++) {
+			std::swap(indices[i], indices[i + rng(static_cast<unsigned int>(population_size - i))]);
+			random_picks.emplace_back(people.get(), people->GetPresentId(indices[i]));
 		}
-		i++;
 	}
-
 	return random_picks;
 }
 
@@ -53,64 +57,44 @@ std::vector<Person> Population::get_random_persons(util::Random& rng, std::size_
 std::vector<Person> Population::get_random_persons(
     util::Random& rng, std::size_t count, std::function<bool(const Person&)> matches)
 {
-	// This function tries to search as efficiently as possible for people who match
-	// the given predicate without skewing the distribution too much.
-	//
-	// The core algorithm used by this function boils down to repeatedly grabbing random
-	// groups of people from the population and testing if they're a match. Note that
-	// there is no bound on how long this can take: if we're SOL, then we'll always end up
-	// picking people who don't match the predicate.
-	//
-	// That issue is compensated for here by growing the sample size exponentially as long as an
-	// iteration does not find any suitable persons until either the entire population is
-	// sampled and we throw an exception or we find enough matching candidates.
+	// This function draws random people one at a time and keeps the ones that match the
+	// given predicate, which takes O(count / fraction of matching people) draws. There is no
+	// bound on how long that can take if hardly anyone matches, so once we've drawn half
+	// of the population we stop guessing: we scan the people we haven't tried yet for
+	// matches and pick the remaining results from those.
 
 	std::vector<Person> results;
-	std::unordered_set<PersonId> result_ids;
-	size_t sample_size = count;
-	while (count > 0) {
-		size_t found = 0;
-		for (auto person : get_random_persons(rng, sample_size)) {
-			if (result_ids.find(person.GetId()) == result_ids.end() && matches(person)) {
-				results.push_back(person);
-				result_ids.insert(person.GetId());
-				count--;
-				found++;
+	results.reserve(count);
+	if (count == 0) {
+		return results;
+	}
 
-				if (count == 0) {
-					return results;
-				}
+	std::unordered_set<PersonId> tried_ids;
+	const auto population_size = static_cast<unsigned int>(size());
+	while (2 * tried_ids.size() < size()) {
+		auto person = Person(people.get(), people->GetPresentId(rng(population_size)));
+		if (tried_ids.insert(person.GetId()).second && matches(person)) {
+			results.push_back(person);
+			if (results.size() == count) {
+				return results;
 			}
 		}
+	}
 
-		if (found == 0) {
-			if (sample_size == size()) {
-				FATAL_ERROR(
-				    "Could not find " + std::to_string(count) + " people matching the predicate.");
-			}
-			sample_size *= 2;
-			if (sample_size > size()) {
-				sample_size = size();
-			}
-		} else {
-			sample_size = count;
+	std::vector<Person> candidates;
+	serial_for([&tried_ids, &matches, &candidates](const Person& p, unsigned int) {
+		if (tried_ids.find(p.GetId()) == tried_ids.end() && matches(p)) {
+			candidates.push_back(p);
 		}
+	});
+	const auto remaining = count - results.size();
+	if (candidates.size() < remaining) {
+		FATAL_ERROR("Could not find " + std::to_string(remaining) + " people matching the predicate.");
+	}
+	for (std::size_t i = 0; i < remaining; i++) {
+		std::swap(candidates[i], candidates[i + rng(static_cast<unsigned int>(candidates.size() - i))]);
+		results.push_back(candidates[i]);
 	}
 	return results;
 }
-
-/// Get the cumulative number of cases.
-unsigned int Population::get_infected_count() const
-{
-	std::atomic<unsigned int> total(0u);
-	util::parallel::parallel_for(
-	    people, util::parallel::get_number_of_threads(),
-	    [&total](const PersonId&, const std::shared_ptr<PersonData>& data, unsigned int) {
-		    const auto& health = data->GetHealth();
-		    if (health.IsInfected() || health.IsRecovered()) {
-			    total++;
-		    }
-	    });
-	return total;
 }
-}
\ No newline at end of file
@@ -1,17 +1,19 @@
 #ifndef POPULATION_H_INCLUDED
 #define POPULATION_H_INCLUDED
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <memory>
 #include <numeric>
+#include <utility>
 #include <vector>
 #include "Person.h"
 #include "core/Atlas.h"
 #include "core/Health.h"
+#include "core/HealthCounts.h"
 #include "geo/GeoPosition.h"
 #include "util/Parallel.h"
-#include "util/ParallelMap.h"
 #include "util/Random.h"
 
 namespace stride {
@@ -22,18 +24,21 @@ namespace stride {
 class Population
 {
 private:
-	util::parallel::ParallelMap<PersonId, std::shared_ptr<PersonData>> people;
+	std::unique_ptr<PersonStore> people;
 	PersonId max_person_id;
 	Atlas atlas;
 	bool has_atlas_flag;
 
 public:
 	/// Creates a population. No atlas is associated with the population.
-	Population() : has_atlas_flag(false) {}
+	Population() : people(std::make_unique<PersonStore>()), max_person_id(0), has_atlas_flag(false) {}
 
 	/// Creates a population. The given Boolean specifies if the population
 	/// includes an atlas.
-	Population(bool has_atlas) : has_atlas_flag(has_atlas) {}
+	Population(bool has_atlas)
+	    : people(std::make_unique<PersonStore>()), max_person_id(0), has_atlas_flag(has_atlas)
+	{
+	}
 
 	Population(const Population&) = delete;
 	Population& operator=(const Population&) = delete;
@@ -45,78 +50,99 @@ public:
 	class const_iterator final
 	{
 	public:
-		typedef decltype(people)::const_iterator map_iterator;
-
-		const_iterator(const map_iterator& map_iterator_val) : map_iterator_val(map_iterator_val) {}
+		const_iterator(PersonStore* store, PersonId id) : store(store), id(id) { SkipAbsent(); }
 		const_iterator(const const_iterator&) = default;
+		const_iterator& operator=(const const_iterator&) = default;
 		const_iterator& operator++()
 		{
-			++map_iterator_val;
+			++id;
+			SkipAbsent();
 			return *this;
 		}
 		const_iterator operator++(int)
 		{
 			auto result = *this;
-			map_iterator_val++;
+			++(*this);
 			return result;
 		}
 		const_iterator& operator--()
 		{
-			--map_iterator_val;
+			do {
+				--id;
+			} while (!store->IsPresent(id));
 			return *this;
 		}
 		const_iterator operator--(int)
 		{
 			auto result = *this;
-			map_iterator_val--;
+			--(*this);
 			return result;
 		}
-		Person operator*() const { return Person(map_iterator_val->first, map_iterator_val->second); }
-		bool operator==(const const_iterator& other) const
-		{
-			return map_iterator_val == other.map_iterator_val;
-		}
-		bool operator!=(const const_iterator& other) const
-		{
-			return map_iterator_val != other.map_iterator_val;
-		}
+		Person operator*() const { return Person(store, id); }
+		bool operator==(const const_iterator& other) const { return id == other.id; }
+		bool operator!=(const const_iterator& other) const { return id != other.id; }
 
 		friend void swap(const_iterator& lhs, const_iterator& rhs);
 
 	private:
-		map_iterator map_iterator_val;
+		/// Moves this iterator forward until it points at a person who is present, or at the end.
+		void SkipAbsent()
+		{
+			const auto capacity = store->GetCapacity();
+			while (id < capacity && !store->IsPresent(id)) {
+				++id;
+			}
+		}
+
+		PersonStore* store;
+		PersonId id;
 	};
 
 	typedef const_iterator iterator;
 
-	/// Inserts a new element into the container constructed in-place with the given args.
+	/// Inserts a new person with the given id, constructing their data in-place from the given args.
 	template <typename... TArgs>
-	const_iterator emplace(TArgs&&... args)
+	Person emplace(PersonId id, TArgs&&... args)
 	{
-		Person value(args...);
-		if (value.GetId() > max_person_id)
-			max_person_id = value.GetId();
+		if (id > max_person_id)
+			max_person_id = id;
 
-		return const_iterator(people.emplace(value.GetId(), value.GetData()).first);
+		people->Emplace(id, PersonData(std::forward<TArgs>(args)...));
+		return Person(people.get(), id);
 	}
 
-	/// Extracts the person with the given id from this population.
-	Person extract(PersonId id)
+	/// Reserves room for people with ids up to (but not including) the given capacity.
+	void reserve(std::size_t capacity) { people->Reserve(capacity); }
+
+	/// Extracts the person with the given id from this population. Their id is free to be reused.
+	PersonData extract(PersonId id) { return people->Extract(id); }
+
+	/// Removes the person with the given id from this population. Their id is free to be reused.
+	void remove(PersonId id) { people->Remove(id); }
+
+	/// Detaches the person with the given id from this population. They keep their id and data,
+	/// but are no longer counted or iterated over until they are reattached.
+	Person detach(PersonId id)
 	{
-		Person result(id, people.find(id)->second);
-		people.erase(id);
-		return result;
+		people->Detach(id);
+		return Person(people.get(), id);
 	}
 
-	/// Gets the person with the given id in this population.
-	Person getPerson(PersonId id) const
+	/// Reattaches the detached person with the given id to this population.
+	Person reattach(PersonId id)
 	{
-		Person result(id, people.find(id)->second);
-		return result;
+		people->Attach(id);
+		return Person(people.get(), id);
 	}
 
+	/// Gets the person with the given id in this population.
+	Person getPerson(PersonId id) const { return Person(people.get(), id); }
+
+	/// Updates everyone's presence in their clusters for a day with the given days off.
+	void update_presence(bool is_work_off, bool is_school_off) { people->UpdatePresence(is_work_off, is_school_off); }
+
 	/// Gets the number of people in this population.
-	auto size() const -> decltype(people.size()) { return people.size(); }
+	std::size_t size() const { return people->GetSize(); }
 
 	/// Tests if this population uses an atlas.
 	bool has_atlas() const { return has_atlas_flag; }
@@ -128,10 +154,10 @@ public:
 	const Atlas& get_atlas() const { return atlas; }
 
 	/// Creates a constant iterator positioned at the first person in this population.
-	const_iterator begin() const { return const_iterator(people.begin()); }
+	const_iterator begin() const { return const_iterator(people.get(), 0); }
 
 	/// Creates a constant iterator positioned just past the last person in this population.
-	const_iterator end() const { return const_iterator(people.end()); }
+	const_iterator end() const { return const_iterator(people.get(), people->GetCapacity()); }
 
 	/// Gets the largest id for any person that has ever been in this population.
 	PersonId get_max_id() const { return max_person_id; }
@@ -145,7 +171,17 @@ public:
 	    util::Random& rng, std::size_t count, std::function<bool(const Person&)> matches);
 
 	/// Get the cumulative number of cases.
-	unsigned int get_infected_count() const;
+	unsigned int get_infected_count() const { return static_cast<unsigned int>(get_health_counts().GetCases()); }
+
+	/// Gets the number of people per health status.
+	const HealthCounts& get_health_counts() const { return people->GetHealthCounts(); }
+
+	/// Adds the given changes to the number of people per health status. Code that changes
+	/// people's health through Person::GetHealth must report the changes here, or call count_health.
+	void add_health_changes(const HealthCounts& changes) { people->AddHealthChanges(changes); }
+
+	/// Recounts the number of people per health status, after health changes that were not reported.
+	void count_health() { people->CountHealth(); }
 
 	/// Get the fraction of the population that is infected.
 	double get_fraction_infected() const { return double(get_infected_count()) / size(); }
@@ -186,10 +222,26 @@ public:
 	template <typename TAction>
 	void parallel_for(unsigned int number_of_threads, const TAction& action) const
 	{
-		stride::util::parallel::parallel_for(
-		    people, number_of_threads,
-		    [&action](const PersonId& id, const std::shared_ptr<PersonData>& data, unsigned int thread_number) {
-			    return action(Person(id, data), thread_number);
+		// Split the id range into a handful of blocks per thread, so the parallelization
+		// library can balance the work between threads.
+		PersonStore* store = people.get();
+		const auto capacity = static_cast<PersonId>(store->GetCapacity());
+		const auto number_of_blocks = 8 * std::max(number_of_threads, 1U);
+		std::vector<std::pair<PersonId, PersonId>> blocks;
+		PersonId block_start = 0;
+		for (const auto block_end : util::parallel::CreateChunks<PersonId>()(capacity, number_of_blocks)) {
+			blocks.emplace_back(block_start, block_end);
+			block_start = block_end;
+		}
+
+		util::parallel::parallel_for(
+		    blocks, number_of_threads,
+		    [store, &action](const std::pair<PersonId, PersonId>& block, unsigned int thread_number) {
+			    for (PersonId id = block.first; id < block.second; id++) {
+				    if (store->IsPresent(id)) {
+					    action(Person(store, id), thread_number);
+				    }
+			    }
 		    });
 	}
 
@@ -198,18 +250,21 @@ public:
 	template <typename TAction>
 	void serial_for(const TAction& action) const
 	{
-		stride::util::parallel::serial_for(
-		    people,
-		    [&action](const PersonId& id, const std::shared_ptr<PersonData>& data, unsigned int thread_number) {
-			    return action(Person(id, data), thread_number);
-		    });
+		PersonStore* store = people.get();
+		const auto capacity = store->GetCapacity();
+		for (PersonId id = 0; id < capacity; id++) {
+			if (store->IsPresent(id)) {
+				action(Person(store, id), 0);
+			}
+		}
 	}
 };
 
 /// Swaps two population iterators.
 inline void swap(typename Population::const_iterator& lhs, typename Population::const_iterator& rhs)
 {
-	std::swap(lhs.map_iterator_val, rhs.map_iterator_val);
+	std::swap(lhs.store, rhs.store);
+	std::swap(lhs.id, rhs.id);
 }
 
 using PopulationRef = std::shared_ptr<const Population>;
@@ -8,6 +8,7 @@
 #include "pop/Model.h"
 #include "pop/Person.h"
 #include "pop/Population.h"
+#include "pop/PopulationFile.h"
 #include "util/Errors.h"
 #include "util/InstallDirs.h"
 #include "util/Random.h"
@@ -19,7 +20,6 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
-#include <spdlog/spdlog.h>
 
 #include <fstream>
 #include <iostream>
@@ -37,7 +37,7 @@ using namespace stride::util;
 
 shared_ptr<Population> PopulationBuilder::Build(
     const SingleSimulationConfig& config, const boost::property_tree::ptree& pt_disease, util::Random& rng,
-    const std::shared_ptr<spdlog::logger>& log)
+    const std::shared_ptr<output::EventLog>& log)
 {
 	// Setup.
 	const auto pop = make_shared<Population>();
@@ -55,27 +55,37 @@ shared_ptr<Population> PopulationBuilder::Build(
 	}
 
 	// Add persons to population.
-	auto pop_file = InstallDirs::OpenDataFile(config.GetPopulationPath());
 	if (boost::algorithm::ends_with(config.GetPopulationPath(), ".csv")) {
 		// Read population data file.
-		string line;
-		getline(*pop_file, line); // step over file header
-		unsigned int person_id = 0U;
-		while (getline(*pop_file, line)) {
-			const auto values = StringUtils::Split(line, ",");
-			const auto risk_averseness =
-			    values.size() > 6 ? StringUtils::FromString<double>(values[6]) : 0.0;
+		auto pop_file = InstallDirs::OpenDataFile(config.GetPopulationPath());
+		const auto columns = PopulationColumns::ReadCsv(*pop_file);
+		population.reserve(columns.size());
+		for (unsigned int person_id = 0U; person_id < columns.size(); ++person_id) {
 			population.emplace(
-			    person_id,
-			    StringUtils::FromString<unsigned int>(values[0]), // age
-			    StringUtils::FromString<unsigned int>(values[1]), // household_id
-			    StringUtils::FromString<unsigned int>(values[2]), // school_id
-			    StringUtils::FromString<unsigned int>(values[3]), // work_id
-			    StringUtils::FromString<unsigned int>(values[4]), // primary_community_id
-			    StringUtils::FromString<unsigned int>(values[5]), // secondary_community_id
-			    disease->Sample(rng),			      // Fate
-			    risk_averseness);				      // risk_averseness
-			++person_id;
+			    person_id, columns.ages[person_id],
+			    columns.cluster_ids[ToSizeType(ClusterType::Household)][person_id],
+			    columns.cluster_ids[ToSizeType(ClusterType::School)][person_id],
+			    columns.cluster_ids[ToSizeType(ClusterType::Work)][person_id],
+			    columns.cluster_ids[ToSizeType(ClusterType::PrimaryCommunity)][person_id],
+			    columns.cluster_ids[ToSizeType(ClusterType::SecondaryCommunity)][person_id],
+			    disease->Sample(rng), columns.risk_averseness[person_id]);
+		}
+	} else if (boost::algorithm::ends_with(config.GetPopulationPath(), ".bin")) {
+		// Map the binary population file, and read its columns in place.
+		const BinaryPopulationFile pop_file(InstallDirs::GetDataDir() / config.GetPopulationPath());
+		const auto ages = pop_file.GetAges();
+		const auto household_ids = pop_file.GetClusterIds(ClusterType::Household);
+		const auto school_ids = pop_file.GetClusterIds(ClusterType::School);
+		const auto work_ids = pop_file.GetClusterIds(ClusterType::Work);
+		const auto primary_community_ids = pop_file.GetClusterIds(ClusterType::PrimaryCommunity);
+		const auto secondary_community_ids = pop_file.GetClusterIds(ClusterType::SecondaryCommunity);
+		const auto risk_averseness = pop_file.GetRiskAverseness();
+		population.reserve(pop_file.size());
+		for (unsigned int person_id = 0U; person_id < pop_file.size(); ++person_id) {
+			population.emplace(
+			    person_id, ages[person_id], household_ids[person_id], school_ids[person_id], work_ids[person_id],
+			    primary_community_ids[person_id], secondary_community_ids[person_id], disease->Sample(rng),
+			    risk_averseness[person_id]);
 		}
 	} else if (boost::algorithm::ends_with(config.GetPopulationPath(), ".xml")) {
 		auto generator = population::Generator::FromConfig(config, *disease, rng);
@@ -86,7 +96,7 @@ shared_ptr<Population> PopulationBuilder::Build(
 	} else {
 		FATAL_ERROR(
 		    "Population file " + config.GetPopulationPath() +
-		    " must be CSV (population data file) or XML (population model file).");
+		    " must be CSV or BIN (population data file) or XML (population model file).");
 	}
 
 	if (population.size() <= 2U) {
@@ -102,7 +112,11 @@ shared_ptr<Population> PopulationBuilder::Build(
 		auto is_not_participating = [](const Person& p) -> bool { return !p.IsParticipatingInSurvey(); };
 		for (auto& pers : population.get_random_persons(rng, num_participants, is_not_participating)) {
 			pers.ParticipateInSurvey();
-			log->info("[PART] {} {} {}", pers.GetId(), pers.GetAge(), pers.GetGender());
+			if (log) {
+				log->GetWriter(0).Append(
+				    {0, pers.GetId(), 0, static_cast<float>(pers.GetAge()), 0.0F,
+				     output::EventKind::Participant, 0, pers.GetGender(), 0});
+			}
 		}
 	}
 
@@ -118,6 +132,7 @@ shared_ptr<Population> PopulationBuilder::Build(
 	for (auto& pers : population.get_random_persons(rng, num_infected, is_susceptible)) {
 		pers.GetHealth().StartInfection();
 	}
+	population.count_health();
 
 	// Done
 	return pop;
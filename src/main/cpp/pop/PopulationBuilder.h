@@ -2,6 +2,7 @@
 #define POPULATION_BUILDER_H_INCLUDED
 
 #include "Population.h"
+#include "output/EventLog.h"
 #include "sim/SimulationConfig.h"
 #include "util/Random.h"
 
@@ -9,7 +10,6 @@
 #include <string>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
-#include <spdlog/spdlog.h>
 
 namespace stride {
 
@@ -29,7 +29,7 @@ public:
 	 */
 	static std::shared_ptr<Population> Build(
 	    const SingleSimulationConfig& config, const boost::property_tree::ptree& pt_disease, util::Random& rng,
-	    const std::shared_ptr<spdlog::logger>& log);
+	    const std::shared_ptr<output::EventLog>& log);
 };
 
 } // end_of_namespace
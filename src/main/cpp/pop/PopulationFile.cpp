@@ -0,0 +1,147 @@
+#include "PopulationFile.h"
+
+#include "util/Errors.h"
+#include "util/StringUtils.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+
+namespace {
+
+/// The header of a binary population file.
+struct Header
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	std::uint64_t size;
+};
+
+static_assert(sizeof(Header) % sizeof(double) == 0, "Columns must be aligned after the header.");
+
+const char g_magic[8] = {'S', 'T', 'R', 'I', 'D', 'E', 'P', 'P'};
+
+/// Written in native byte order, so it only reads back as this value on machines with the same byte order.
+const std::uint32_t g_byte_order = 0x01020304;
+
+/// Gets the size of a file with the given number of people.
+std::size_t FileLength(std::size_t size)
+{
+	return sizeof(Header) + size * (2 * sizeof(double) + NumOfClusterTypes() * sizeof(std::uint32_t));
+}
+
+} // namespace
+
+PopulationColumns PopulationColumns::ReadCsv(std::istream& csv)
+{
+	PopulationColumns columns;
+	string line;
+	getline(csv, line); // step over file header
+	while (getline(csv, line)) {
+		const auto values = StringUtils::Split(line, ",");
+		if (values.size() < 1 + NumOfClusterTypes()) {
+			FATAL_ERROR("Population file line has too few values: " + line);
+		}
+		columns.ages.push_back(StringUtils::FromString<unsigned int>(values[0]));
+		for (unsigned int i = 0; i < NumOfClusterTypes(); i++) {
+			columns.cluster_ids[i].push_back(StringUtils::FromString<unsigned int>(values[1 + i]));
+		}
+		columns.risk_averseness.push_back(values.size() > 6 ? StringUtils::FromString<double>(values[6]) : 0.0);
+	}
+	return columns;
+}
+
+BinaryPopulationFile::BinaryPopulationFile(const boost::filesystem::path& path)
+    : m_data(MAP_FAILED), m_length(0), m_size(0), m_ages(nullptr), m_risk_averseness(nullptr), m_cluster_ids{}
+{
+	const int fd = open(path.string().c_str(), O_RDONLY);
+	if (fd < 0) {
+		FATAL_ERROR("Error opening file " + path.string());
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+		close(fd);
+		FATAL_ERROR("Population file " + path.string() + " is too short.");
+	}
+	m_length = static_cast<std::size_t>(status.st_size);
+	m_data = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (m_data == MAP_FAILED) {
+		FATAL_ERROR("Error mapping file " + path.string());
+	}
+
+	Header header;
+	std::memcpy(&header, m_data, sizeof(Header));
+	if (std::memcmp(header.magic, g_magic, sizeof(g_magic)) != 0) {
+		munmap(m_data, m_length);
+		FATAL_ERROR("File " + path.string() + " is not a binary population file.");
+	}
+	if (header.version != g_version || header.byte_order != g_byte_order) {
+		munmap(m_data, m_length);
+		FATAL_ERROR("Population file " + path.string() + " has an unsupported version or byte order.");
+	}
+	if (FileLength(header.size) != m_length) {
+		munmap(m_data, m_length);
+		FATAL_ERROR("Population file " + path.string() + " has the wrong size.");
+	}
+
+	m_size = header.size;
+	const char* column = static_cast<const char*>(m_data) + sizeof(Header);
+	m_ages = reinterpret_cast<const double*>(column);
+	column += m_size * sizeof(double);
+	m_risk_averseness = reinterpret_cast<const double*>(column);
+	column += m_size * sizeof(double);
+	for (auto& cluster_ids : m_cluster_ids) {
+		cluster_ids = reinterpret_cast<const std::uint32_t*>(column);
+		column += m_size * sizeof(std::uint32_t);
+	}
+
+	// People are read in order.
+	madvise(m_data, m_length, MADV_SEQUENTIAL);
+}
+
+BinaryPopulationFile::~BinaryPopulationFile() { munmap(m_data, m_length); }
+
+void BinaryPopulationFile::Write(const boost::filesystem::path& path, const PopulationColumns& columns)
+{
+	const auto size = columns.size();
+	if (columns.risk_averseness.size() != size) {
+		FATAL_ERROR("Population columns have different sizes.");
+	}
+	for (const auto& cluster_ids : columns.cluster_ids) {
+		if (cluster_ids.size() != size) {
+			FATAL_ERROR("Population columns have different sizes.");
+		}
+	}
+
+	boost::filesystem::ofstream file(path, ios::binary | ios::trunc);
+	if (!file.is_open()) {
+		FATAL_ERROR("Error opening file " + path.string());
+	}
+	Header header;
+	std::memcpy(header.magic, g_magic, sizeof(g_magic));
+	header.version = g_version;
+	header.byte_order = g_byte_order;
+	header.size = size;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(reinterpret_cast<const char*>(columns.ages.data()), size * sizeof(double));
+	file.write(reinterpret_cast<const char*>(columns.risk_averseness.data()), size * sizeof(double));
+	for (const auto& cluster_ids : columns.cluster_ids) {
+		file.write(reinterpret_cast<const char*>(cluster_ids.data()), size * sizeof(std::uint32_t));
+	}
+	if (!file) {
+		FATAL_ERROR("Error writing file " + path.string());
+	}
+}
+
+} // end_of_namespace
@@ -0,0 +1,80 @@
+#ifndef POPULATION_FILE_H_INCLUDED
+#define POPULATION_FILE_H_INCLUDED
+
+#include "core/ClusterType.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace stride {
+
+/**
+ * The attributes of every person in a population file, as columns indexed by person id.
+ */
+struct PopulationColumns
+{
+	std::vector<double> ages;
+	std::vector<double> risk_averseness;
+	std::array<std::vector<std::uint32_t>, NumOfClusterTypes()> cluster_ids;
+
+	/// Gets the number of people.
+	std::size_t size() const { return ages.size(); }
+
+	/// Reads the columns from a population CSV file (age, the five cluster ids and, optionally,
+	/// the risk averseness; after a header line).
+	static PopulationColumns ReadCsv(std::istream& csv);
+};
+
+/**
+ * A binary population file that has been mapped into memory. The file starts with a header
+ * (magic, format version, byte order mark and the number of people), followed by the columns:
+ * ages and risk averseness as doubles, then the ids of the five clusters (in ClusterType order)
+ * as 32-bit integers. Columns are read in place, so loading a population doesn't parse anything.
+ */
+class BinaryPopulationFile
+{
+public:
+	/// The version of the format that is written, and the only version that can be read.
+	static constexpr std::uint32_t g_version = 1;
+
+	/// Maps the file at the given path. Throws a fatal error if it isn't a valid population file.
+	explicit BinaryPopulationFile(const boost::filesystem::path& path);
+
+	BinaryPopulationFile(const BinaryPopulationFile&) = delete;
+	BinaryPopulationFile& operator=(const BinaryPopulationFile&) = delete;
+
+	/// Unmaps the file.
+	~BinaryPopulationFile();
+
+	/// Gets the number of people.
+	std::size_t size() const { return m_size; }
+
+	/// Gets everyone's age.
+	const double* GetAges() const { return m_ages; }
+
+	/// Gets everyone's risk averseness.
+	const double* GetRiskAverseness() const { return m_risk_averseness; }
+
+	/// Gets everyone's cluster id for the given cluster type.
+	const std::uint32_t* GetClusterIds(ClusterType type) const { return m_cluster_ids[ToSizeType(type)]; }
+
+	/// Writes the given columns to a binary population file.
+	static void Write(const boost::filesystem::path& path, const PopulationColumns& columns);
+
+private:
+	void* m_data;
+	std::size_t m_length;
+	std::size_t m_size;
+	const double* m_ages;
+	const double* m_risk_averseness;
+	std::array<const std::uint32_t*, NumOfClusterTypes()> m_cluster_ids;
+};
+
+} // end_of_namespace
+
+#endif // include guard
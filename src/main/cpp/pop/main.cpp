@@ -0,0 +1,68 @@
+#include "pop/PopulationFile.h"
+#include "util/Stopwatch.h"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <tclap/CmdLine.h>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace TCLAP;
+
+/// Main program of the stridepop program, which converts a population CSV file to the binary format.
+int main(int argc, char** argv)
+{
+	int exit_status = EXIT_SUCCESS;
+	try {
+		// -----------------------------------------------------------------------------------------
+		// Parse command line.
+		// -----------------------------------------------------------------------------------------
+		CmdLine cmd("stridepop", ' ', "1.0", false);
+
+		ValueArg<string> output_file(
+		    "o", "output", "The binary population file to write (defaults to the input file with extension .bin)",
+		    false, "", "BIN FILE", cmd);
+
+		UnlabeledValueArg<string> input_file("input", "The population CSV file to convert", true, "", "CSV FILE", cmd);
+
+		cmd.parse(argc, argv);
+
+		const boost::filesystem::path input_path(input_file.getValue());
+		boost::filesystem::path output_path(output_file.getValue());
+		if (output_path.empty()) {
+			output_path = boost::filesystem::path(input_path).replace_extension(".bin");
+		}
+
+		// -----------------------------------------------------------------------------------------
+		// Convert.
+		// -----------------------------------------------------------------------------------------
+		boost::filesystem::ifstream csv(input_path);
+		if (!csv.is_open()) {
+			throw runtime_error("Error opening file " + input_path.string());
+		}
+		Stopwatch<> read_clock("read_clock", true);
+		const auto columns = PopulationColumns::ReadCsv(csv);
+		read_clock.Stop();
+
+		Stopwatch<> write_clock("write_clock", true);
+		BinaryPopulationFile::Write(output_path, columns);
+		write_clock.Stop();
+
+		cout << "Converted " << columns.size() << " people from " << input_path.string() << " to "
+		     << output_path.string() << endl
+		     << "  read time: " << read_clock.ToString() << "  write time: " << write_clock.ToString() << endl;
+
+	} catch (exception& e) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: " << e.what() << endl;
+	} catch (...) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: "
+		     << "Unknown exception." << endl;
+	}
+	return exit_status;
+}
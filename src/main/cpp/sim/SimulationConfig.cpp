@@ -14,6 +14,7 @@
 #include <boost/property_tree/ptree.hpp>
 #include "calendar/Calendar.h"
 #include "core/LogMode.h"
+#include "core/RngEngine.h"
 #include "multiregion/TravelModel.h"
 #include "util/Errors.h"
 #include "util/InstallDirs.h"
@@ -24,14 +25,19 @@ using namespace stride::util;
 namespace stride {
 
 CommonSimulationConfig::CommonSimulationConfig()
-    : track_index_case(false), rng_seed(), r0(), seeding_rate(), immunity_rate(), number_of_days(),
-      disease_config_file_name(), number_of_survey_participants(), initial_calendar(), contact_matrix_file_name()
+    : track_index_case(false), rng_seed(), rng_engine(RngEngine::Mrg2), r0(), seeding_rate(), immunity_rate(), number_of_days(),
+      disease_config_file_name(), number_of_survey_participants(), initial_calendar(), contact_matrix_file_name(),
+      checkpoint_compression(), checkpoint_deltas(false), checkpoint_full_interval(10)
 {
 }
 
 void CommonSimulationConfig::Parse(const boost::property_tree::ptree& pt)
 {
 	rng_seed = pt.get<unsigned int>("rng_seed");
+	auto rng_engine_string = pt.get<std::string>("rng_engine", "Mrg2");
+	rng_engine = IsRngEngine(rng_engine_string) && ToRngEngine(rng_engine_string) != RngEngine::Null
+			 ? ToRngEngine(rng_engine_string)
+			 : throw std::runtime_error(std::string(__func__) + "> Invalid input for RngEngine.");
 	r0 = pt.get<double>("r0");
 	seeding_rate = pt.get<double>("seeding_rate");
 	immunity_rate = pt.get<double>("immunity_rate");
@@ -12,6 +12,7 @@
 #include <boost/property_tree/ptree.hpp>
 #include "calendar/Calendar.h"
 #include "core/LogMode.h"
+#include "core/RngEngine.h"
 #include "multiregion/TravelModel.h"
 
 namespace stride {
@@ -30,6 +31,9 @@ struct CommonSimulationConfig final
 	/// The initial seed for the random number generator.
 	unsigned int rng_seed;
 
+	/// The random number engine that is used for contacts and transmissions.
+	RngEngine rng_engine;
+
 	/// The r0 value.
 	double r0;
 
@@ -60,6 +64,16 @@ struct CommonSimulationConfig final
 	/// The amount of days between 2 checkpoints. The first and last will be saved regardless.
 	unsigned int checkpoint_interval;
 
+	/// The deflate level (0 to 9) with which checkpoints are compressed, 0 meaning no compression.
+	unsigned int checkpoint_compression;
+
+	/// Whether checkpoints after the first one only store what changed since the previous checkpoint.
+	bool checkpoint_deltas;
+
+	/// In delta mode, every checkpoint_full_interval-th checkpoint is stored in full, so that loading a date
+	/// never needs to replay more deltas than that.
+	unsigned int checkpoint_full_interval;
+
 	/// Fills this configuration with data from the given ptree.
 	void Parse(const boost::property_tree::ptree& pt);
 };
@@ -11,9 +11,12 @@
 #include "pop/Population.h"
 #include "util/Parallel.h"
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <boost/property_tree/ptree.hpp>
-#include <spdlog/spdlog.h>
 
 namespace stride {
 
@@ -32,18 +35,136 @@ void Simulator::SetTrackIndexCase(bool track_index_case) { m_track_index_case =
 template <LogMode log_level, bool track_index_case, typename local_information_policy>
 void Simulator::UpdateClusters()
 {
-	auto log = m_log;
-
-	auto action = [this, log](Cluster& cluster, unsigned int thread_id) {
+	const auto day = static_cast<unsigned int>(m_calendar->GetSimulationDay());
+	auto action = [this, day](Cluster& cluster, unsigned int worker_id) {
+		const auto events = m_log ? &m_log->GetWriter(worker_id) : nullptr;
+		auto& rng = m_rng_handler[worker_id];
+		rng.SetStream(day, cluster.GetClusterType(), cluster.GetId());
 		Infector<log_level, track_index_case, local_information_policy>::Execute(
-		    cluster, m_disease_profile, m_rng_handler[thread_id], m_calendar, log);
+		    cluster, m_disease_profile, rng, m_health_changes[worker_id],
+		    m_new_cases[worker_id], m_calendar, events);
 	};
 
-	stride::util::parallel::parallel_for(m_clusters.m_households, m_num_threads, action);
-	stride::util::parallel::parallel_for(m_clusters.m_school_clusters, m_num_threads, action);
-	stride::util::parallel::parallel_for(m_clusters.m_work_clusters, m_num_threads, action);
-	stride::util::parallel::parallel_for(m_clusters.m_primary_community, m_num_threads, action);
-	stride::util::parallel::parallel_for(m_clusters.m_secondary_community, m_num_threads, action);
+	// Only the NoLocalInformation infector can skip clusters without infectious members: the
+	// others (and the contact logger) look at every contact.
+	const bool only_active =
+	    std::is_same<local_information_policy, NoLocalInformation>::value && log_level != LogMode::Contacts;
+	std::vector<std::vector<Cluster*>> active_clusters(NumOfClusterTypes());
+	if (only_active) {
+		for (const auto& key : m_active_clusters.GetActiveClusters()) {
+			active_clusters[ToSizeType(key.first)].push_back(&GetClustersOfType(key.first)[key.second]);
+		}
+	}
+
+	// A person is a member of at most one cluster of every type, so the clusters of a single type
+	// never share anyone. Every type gets a pass of its own, and a pass only starts once the
+	// previous one is done, so no two threads ever update the same person's health.
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		const auto type = static_cast<ClusterType>(i);
+		if (only_active) {
+			if (active_clusters[i].empty()) {
+				continue;
+			}
+			m_cluster_scheduler->Plan(active_clusters[i]);
+		} else {
+			m_cluster_scheduler->PlanAll({&GetClustersOfType(type)});
+		}
+		m_cluster_scheduler->Run(action);
+	}
+}
+
+std::vector<Cluster>& Simulator::GetClustersOfType(ClusterType type)
+{
+	switch (type) {
+	case ClusterType::Household:
+		return m_clusters.m_households;
+	case ClusterType::School:
+		return m_clusters.m_school_clusters;
+	case ClusterType::Work:
+		return m_clusters.m_work_clusters;
+	case ClusterType::PrimaryCommunity:
+		return m_clusters.m_primary_community;
+	case ClusterType::SecondaryCommunity:
+		return m_clusters.m_secondary_community;
+	default:
+		throw runtime_error(std::string(__func__) + "> Should not reach default.");
+	}
+}
+
+void Simulator::UpdateActiveClusters(const Person& person, bool is_infectious)
+{
+	// Cluster id '0' means "not present in any cluster of that type".
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		const auto type = static_cast<ClusterType>(i);
+		const auto cluster_id = person.GetClusterId(type);
+		if (cluster_id > 0) {
+			if (is_infectious) {
+				m_active_clusters.AddInfectious(type, cluster_id);
+			} else {
+				m_active_clusters.RemoveInfectious(type, cluster_id);
+			}
+		}
+	}
+}
+
+void Simulator::InitializeClusters()
+{
+	// Count the members of every cluster, to determine the number of clusters of each type and
+	// to size them up front.
+	std::array<std::vector<std::size_t>, NumOfClusterTypes()> sizes;
+	for (auto& type_sizes : sizes) {
+		type_sizes.assign(1, 0);
+	}
+	m_population->serial_for([&sizes](const Person& p, unsigned int) {
+		for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+			const auto cluster_id = p.GetClusterId(static_cast<ClusterType>(i));
+			if (cluster_id > 0) {
+				if (cluster_id >= sizes[i].size()) {
+					sizes[i].resize(cluster_id + 1, 0);
+				}
+				sizes[i][cluster_id]++;
+			}
+		}
+	});
+
+	// Keep separate id counter to provide a unique id for every cluster.
+	unsigned int cluster_id = 1;
+	std::vector<ClusterType> types;
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		const auto type = static_cast<ClusterType>(i);
+		auto& clusters = GetClustersOfType(type);
+		clusters.clear();
+		clusters.reserve(sizes[i].size());
+		for (const auto size : sizes[i]) {
+			clusters.emplace_back(cluster_id, type);
+			clusters.back().Reserve(size);
+			cluster_id++;
+		}
+		types.push_back(type);
+	}
+
+	// Each type of cluster is filled by a single thread. Adding the members one health partition at a
+	// time means that every member is appended, in the same order as AddPersonToClusters.
+	parallel::parallel_for(types, m_num_threads, [this](ClusterType& type, unsigned int) {
+		auto& clusters = GetClustersOfType(type);
+		for (std::size_t partition = 0; partition < 3; partition++) {
+			m_population->serial_for([&](const Person& p, unsigned int) {
+				const auto cluster_id = p.GetClusterId(type);
+				if (cluster_id > 0 && Cluster::GetHealthPartition(p.GetHealth()) == partition) {
+					clusters[cluster_id].AddPerson(p);
+				}
+			});
+		}
+	});
+
+	m_active_clusters.Clear();
+	m_disease_events.Clear();
+	m_population->serial_for([this](const Person& p, unsigned int) {
+		if (p.GetHealth().IsInfectious()) {
+			UpdateActiveClusters(p, true);
+		}
+		m_disease_events.Update(p.GetId(), p.GetHealth());
+	});
 }
 
 void Simulator::AddPersonToClusters(const Person& person)
@@ -69,6 +190,46 @@ void Simulator::AddPersonToClusters(const Person& person)
 	if (secCom_id > 0) {
 		m_clusters.m_secondary_community[secCom_id].AddPerson(person);
 	}
+
+	if (person.GetHealth().IsInfectious()) {
+		UpdateActiveClusters(person, true);
+	}
+}
+
+void Simulator::MoveToCasesInClusters(const Person& person)
+{
+	// Cluster id '0' means "not present in any cluster of that type".
+	for (std::size_t i = 0; i < NumOfClusterTypes(); i++) {
+		const auto type = static_cast<ClusterType>(i);
+		const auto cluster_id = person.GetClusterId(type);
+		if (cluster_id > 0) {
+			GetClustersOfType(type)[cluster_id].MoveToCases(person);
+		}
+	}
+}
+
+void Simulator::RemoveFromDiseaseEvents(const Person& person)
+{
+	const auto days = m_disease_events.GetDaysBehind(person.GetId());
+	if (days > 0) {
+		person.Update(days);
+	}
+	m_disease_events.Remove(person.GetId());
+}
+
+void Simulator::UpdateHealth()
+{
+	for (const auto id : m_disease_events.AdvanceDay()) {
+		const auto person = m_population->getPerson(id);
+		const auto status = person.GetHealth().GetHealthStatus();
+		if (person.Update(m_disease_events.GetDaysBehind(id))) {
+			UpdateActiveClusters(person, person.GetHealth().IsInfectious());
+		}
+		if (person.GetHealth().GetHealthStatus() != status) {
+			m_health_changes.front().Move(status, person.GetHealth().GetHealthStatus());
+		}
+		m_disease_events.Update(id, person.GetHealth());
+	}
 }
 
 void Simulator::RemovePersonFromClusters(const Person& person)
@@ -94,6 +255,10 @@ void Simulator::RemovePersonFromClusters(const Person& person)
 	if (secCom_id > 0) {
 		m_clusters.m_secondary_community[secCom_id].RemovePerson(person);
 	}
+
+	if (person.GetHealth().IsInfectious()) {
+		UpdateActiveClusters(person, false);
+	}
 }
 
 PersonId Simulator::GeneratePersonId()
@@ -128,17 +293,18 @@ void Simulator::AcceptVisitors(const multiregion::SimulationStepInput& input)
 {
 	for (const auto& returning_expat : input.expatriates) {
 		// Return the expatriate to this region's population.
-		const auto& home_expat =
-		    *m_population->emplace(m_expatriates.ExtractExpatriate(returning_expat.GetId()));
+		const auto home_expat =
+		    m_population->reattach(m_expatriates.ExtractExpatriate(returning_expat.person_id).GetId());
 
 		// Update the expatriate's stats.
-		home_expat.GetHealth() = returning_expat.GetHealth();
-		if (returning_expat.IsParticipatingInSurvey()) {
+		home_expat.SetHealth(returning_expat.person.health);
+		if (returning_expat.person.is_participant) {
 			home_expat.ParticipateInSurvey();
 		}
 
 		// Add the returning expatriate to their clusters.
 		AddPersonToClusters(home_expat);
+		m_disease_events.Update(home_expat.GetId(), home_expat.GetHealth());
 	}
 
 	for (const auto& visitor : input.visitors) {
@@ -150,19 +316,20 @@ void Simulator::AcceptVisitors(const multiregion::SimulationStepInput& input)
 		auto secondary_community_id = (*m_travel_rng)(m_clusters.m_secondary_community.size() - 1);
 
 		// Insert the visitor in the population.
-		Person local_visitor = *m_population->emplace(
-		    id, visitor.person.GetAge(), household_id, 0, work_id, primary_community_id, secondary_community_id,
+		Person local_visitor = m_population->emplace(
+		    id, visitor.person.age, household_id, 0, work_id, primary_community_id, secondary_community_id,
 		    disease::Fate());
 
 		// Set the visitor's health.
-		local_visitor.GetHealth() = visitor.person.GetHealth();
+		local_visitor.SetHealth(visitor.person.health);
 
 		// Add the visitor to their assigned clusters.
 		AddPersonToClusters(local_visitor);
+		m_disease_events.Update(id, local_visitor.GetHealth());
 
 		// Add an entry to the visitor log.
 		multiregion::VisitorId visitor_desc;
-		visitor_desc.home_id = visitor.person.GetId();
+		visitor_desc.home_id = visitor.person_id;
 		visitor_desc.visitor_id = id;
 		m_visitors.AddVisitor(visitor_desc, visitor.home_region, visitor.return_day);
 	}
@@ -175,15 +342,20 @@ multiregion::SimulationStepOutput Simulator::ReturnVisitors()
 	auto today = m_calendar->GetSimulationDay();
 	for (const auto& expatriate_pair : m_visitors.ExtractVisitors(today)) {
 		for (const auto& expatriate : expatriate_pair.second) {
-			auto person = m_population->extract(expatriate.visitor_id);
-
-			// Recycle the person's id and their household.
-			RecyclePersonId(person.GetId());
-			RecycleHousehold(person.GetClusterId(ClusterType::Household));
+			// Remove the visitor from their clusters before their id is freed up for reuse.
+			const auto person = m_population->getPerson(expatriate.visitor_id);
+			RemovePersonFromClusters(person);
+			RemoveFromDiseaseEvents(person);
 
 			// Restore the person's id to their home id.
 			returning_expatriates.emplace_back(
-			    person.WithId(expatriate.home_id), expatriate_pair.first, today);
+			    expatriate.home_id, multiregion::TravellerData(person), expatriate_pair.first, today);
+
+			// Recycle the person's id and their household.
+			const auto household_id = person.GetClusterId(ClusterType::Household);
+			m_population->remove(expatriate.visitor_id);
+			RecyclePersonId(expatriate.visitor_id);
+			RecycleHousehold(household_id);
 		}
 	}
 
@@ -228,15 +400,17 @@ multiregion::SimulationStepOutput Simulator::ReturnVisitors()
 
 		// Remove the person from their clusters.
 		RemovePersonFromClusters(visitor);
+		RemoveFromDiseaseEvents(visitor);
 
 		auto return_date =
 		    today + (*m_travel_rng)(
 				(int)travel_model->GetMinTravelDuration(), (int)travel_model->GetMaxTravelDuration());
 
-		outgoing_visitors.emplace_back(visitor, target_region_id, return_date);
+		outgoing_visitors.emplace_back(
+		    visitor.GetId(), multiregion::TravellerData(visitor), target_region_id, return_date);
 
-		// Remove the person from the population and add them to the expatriate journal.
-		m_expatriates.AddExpatriate(m_population->extract(visitor.GetId()));
+		// Detach the person from the population and add them to the expatriate journal.
+		m_expatriates.AddExpatriate(m_population->detach(visitor.GetId()));
 	}
 
 	return {std::move(outgoing_visitors), std::move(returning_expatriates)};
@@ -255,11 +429,14 @@ multiregion::SimulationStepOutput Simulator::TimeStep(const multiregion::Simulat
 	const bool is_work_off{days_off->IsWorkOff()};
 	const bool is_school_off{days_off->IsSchoolOff()};
 
-	const double fraction_infected = m_population->get_fraction_infected();
+	m_population->update_presence(is_work_off, is_school_off);
 
-	m_population->parallel_for(m_num_threads, [=](const Person& p, unsigned int) {
-		p.Update(is_work_off, is_school_off, fraction_infected);
-	});
+	m_health_changes.resize(max(m_num_threads, 1U));
+	m_new_cases.resize(max(m_num_threads, 1U));
+	if (m_log) {
+		m_log->ReserveWriters(max(m_num_threads, 1U));
+	}
+	UpdateHealth();
 
 	if (m_track_index_case) {
 		switch (m_log_level) {
@@ -291,6 +468,32 @@ multiregion::SimulationStepOutput Simulator::TimeStep(const multiregion::Simulat
 		}
 	}
 
+	// Clusters are only repartitioned once they have all been updated, so every cluster sees the same
+	// partition of its members, whichever pass it was in. The cases are moved in order of id, so the
+	// clusters end up the same no matter which thread found them.
+	vector<PersonId> new_cases;
+	for (auto& cases : m_new_cases) {
+		new_cases.insert(new_cases.end(), cases.begin(), cases.end());
+		cases.clear();
+	}
+	sort(new_cases.begin(), new_cases.end());
+	for (auto id : new_cases) {
+		const auto person = m_population->getPerson(id);
+		MoveToCasesInClusters(person);
+		m_disease_events.Update(id, person.GetHealth());
+	}
+
+	// Apply the changes in health that every thread recorded during this step.
+	for (auto& changes : m_health_changes) {
+		m_population->add_health_changes(changes);
+		changes.Clear();
+	}
+
+	// Write the events that the threads logged in full blocks.
+	if (m_log) {
+		m_log->Flush();
+	}
+
 	m_calendar->AdvanceDay();
 	return ReturnVisitors();
 }
@@ -300,14 +503,28 @@ multiregion::SimulationStepOutput Simulator::TimeStep(const multiregion::Simulat
 	/// Writes the current checkpoint
 	void Simulator::SaveCheckPoint(unsigned int day)
 	{
-		cp->OpenFile();
-		cp->SaveCheckPoint(*this, day);
-		cp->CloseFile();
+		// Backpressure: at most one snapshot is kept in memory while it is being written.
+		WaitForCheckPoint();
+		m_checkpoint_write = std::async(
+		    std::launch::async, [this, snapshot = checkpoint::CheckPoint::TakeSnapshot(*this, day)]() mutable {
+			    cp->OpenFile();
+			    cp->WriteSnapshot(std::move(snapshot));
+			    cp->CloseFile();
+		    });
+	}
+
+	/// Waits for the checkpoint that is being written
+	void Simulator::WaitForCheckPoint()
+	{
+		if (m_checkpoint_write.valid()) {
+			m_checkpoint_write.get();
+		}
 	}
 
 	/// Writes the Atlas
 	void Simulator::WriteAtlas()
 	{
+		WaitForCheckPoint();
 		cp->OpenFile();
 		cp->WriteAtlas(m_population->get_atlas());
 		cp->CloseFile();
@@ -316,7 +533,10 @@ multiregion::SimulationStepOutput Simulator::TimeStep(const multiregion::Simulat
 	/// Creates the checkpoint
 	void Simulator::CreateCheckPoint(const std::string& name, const std::string& calendarName)
 	{
-		cp = std::make_unique<checkpoint::CheckPoint>(name);
+		WaitForCheckPoint();
+		cp = std::make_unique<checkpoint::CheckPoint>(
+		    name, m_config.common_config->checkpoint_compression, m_config.common_config->checkpoint_deltas,
+		    m_config.common_config->checkpoint_full_interval);
 		cp->CreateFile();
 		cp->OpenFile();
 		cp->WriteConfig(m_config);
@@ -2,20 +2,25 @@
 #define SIMULATOR_H_INCLUDED
 
 #include "behaviour/information_policies/NoLocalInformation.h"
+#include "core/ActiveClusterIndex.h"
 #include "core/Cluster.h"
+#include "core/ClusterScheduler.h"
+#include "core/DiseaseEventQueue.h"
 #include "core/DiseaseProfile.h"
+#include "core/HealthCounts.h"
 #include "core/LogMode.h"
 #include "core/RngHandler.h"
 #include "multiregion/Visitor.h"
 #include "multiregion/VisitorJournal.h"
+#include "output/EventLog.h"
 #include "pop/Population.h"
 #include "sim/SimulationConfig.h"
 
+#include <future>
 #include <memory>
 #include <queue>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
-#include <spdlog/spdlog.h>
 
 #if USE_HDF5
 #include "checkpoint/CheckPoint.h"
@@ -82,6 +87,10 @@ public:
 	/// Sets the expatriate journal
 	void SetExpatriates(const multiregion::ExpatriateJournal& expatriates) { m_expatriates = expatriates; }
 
+	/// Replaces the clusters with ones that are rebuilt from the population's cluster ids, and
+	/// schedules the disease of everyone who is infected.
+	void InitializeClusters();
+
 	/// Change track_index_case setting.
 	void SetTrackIndexCase(bool track_index_case);
 
@@ -91,14 +100,24 @@ public:
 	/// Tests if this simulation has run to completion.
 	bool IsDone() const { return m_calendar->GetSimulationDay() >= m_config.common_config->number_of_days; }
 
+	/// Gets the time each of the cluster scheduler's workers has spent so far.
+	std::vector<ClusterScheduler::WorkerTimes> GetWorkerTimes() const { return m_cluster_scheduler->GetWorkerTimes(); }
+
+	/// Gets the number of days the given person has been infected. Only the days on which their disease
+	/// changes are processed, so the count in their health may lag behind.
+	unsigned int GetDaysInfected(const Person& person) const
+	{
+		return person.GetHealth().GetDaysInfected() + m_disease_events.GetDaysBehind(person.GetId());
+	}
+
 	/// Tests if the person is a visitor to this simulation.
 	bool IsVisitor(PersonId id) const { return m_visitors.IsVisitor(id); }
 
 	/// Gets the visitor journal
-	multiregion::VisitorJournal GetVistiorJournal() const { return m_visitors; }
+	const multiregion::VisitorJournal& GetVistiorJournal() const { return m_visitors; }
 
 	/// Gets the expatriate journal
-	multiregion::ExpatriateJournal GetExpatriateJournal() const { return m_expatriates; }
+	const multiregion::ExpatriateJournal& GetExpatriateJournal() const { return m_expatriates; }
 
 	/// Runs the given action on every resident who is currently present
 	/// in the simulation. More than one invocation of `action` may be
@@ -174,9 +193,14 @@ public:
 
 #if USE_HDF5
 
-	/// Writes the current checkpoint
+	/// Takes a snapshot of the current state and writes it to the checkpoint on a background thread. If the
+	/// previous snapshot is still being written, this first waits until it is done.
 	void SaveCheckPoint(unsigned int day);
 
+	/// Waits until the snapshot that is being written (if any) is in the checkpoint, and rethrows any
+	/// error that occurred while writing it.
+	void WaitForCheckPoint();
+
 	/// Writes the Atlas
 	void WriteAtlas();
 
@@ -198,6 +222,21 @@ private:
 	/// Removes the given person from the clusters they've been assigned to.
 	void RemovePersonFromClusters(const Person& person);
 
+	/// Moves the given person, who has just been infected, to the cases of all their clusters.
+	void MoveToCasesInClusters(const Person& person);
+
+	/// Brings the given person's health up to date and takes them out of the disease event queue.
+	void RemoveFromDiseaseEvents(const Person& person);
+
+	/// Updates the health of the people whose disease changes today.
+	void UpdateHealth();
+
+	/// Gets the clusters of the given type.
+	std::vector<Cluster>& GetClustersOfType(ClusterType type);
+
+	/// Adds the given person's clusters to (or removes them from) the active cluster index.
+	void UpdateActiveClusters(const Person& person, bool is_infectious);
+
 	/// Generates an id for a person that is not in use.
 	PersonId GeneratePersonId();
 
@@ -219,16 +258,19 @@ private:
 	/// Configuration for this simulator.
 	SingleSimulationConfig m_config;
 
-	/// Log for this simulator.
-	std::shared_ptr<spdlog::logger> m_log;
+	/// Log of the contacts or transmissions in this simulator (null if nothing is logged).
+	std::shared_ptr<output::EventLog> m_log;
 
 private:
 	/// The number of (OpenMP) threads.
 	unsigned int m_num_threads;
 
-	/// Pointer to the RngHandlers.
+	/// The RngHandlers, one per thread. They restart at the stream of every cluster they process.
 	std::vector<RngHandler> m_rng_handler;
 
+	/// Schedules the clusters on the threads. Worker i uses the i-th RngHandler.
+	std::unique_ptr<ClusterScheduler> m_cluster_scheduler;
+
 	/// A random number generator for travel.
 	std::shared_ptr<util::Random> m_travel_rng;
 
@@ -251,6 +293,18 @@ private:
 	/// Struct containing all Clusters.
 	ClusterStruct m_clusters;
 
+	/// The clusters that have at least one infectious member.
+	ActiveClusterIndex m_active_clusters;
+
+	/// The days on which the disease of the infected people changes.
+	DiseaseEventQueue m_disease_events;
+
+	/// The people who were infected in a cluster during the current step, per thread.
+	std::vector<std::vector<PersonId>> m_new_cases;
+
+	/// The changes in the number of people per health status during the current step, per thread.
+	std::vector<HealthCounts> m_health_changes;
+
 	/// A list of unused households which can are eligible for recycling.
 	std::queue<std::size_t> m_unused_households;
 
@@ -266,6 +320,10 @@ private:
 #if USE_HDF5
 	/// The checkpoint connected to this simulator
 	std::unique_ptr<checkpoint::CheckPoint> cp;
+
+	/// Writes a snapshot to the checkpoint in the background. Declared after the checkpoint, so it is
+	/// destroyed (and the write is finished) before the checkpoint is.
+	std::future<void> m_checkpoint_write;
 #endif
 
 private:
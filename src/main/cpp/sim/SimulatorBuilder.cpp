@@ -2,6 +2,7 @@
 
 #include "calendar/Calendar.h"
 #include "core/Cluster.h"
+#include "core/ClusterScheduler.h"
 #include "core/ClusterType.h"
 #include "core/ContactProfile.h"
 #include "core/Infector.h"
@@ -26,7 +27,7 @@ using namespace boost::property_tree;
 using namespace stride::util;
 
 shared_ptr<Simulator> SimulatorBuilder::Build(
-    const string& config_file_name, const std::shared_ptr<spdlog::logger>& log, unsigned int num_threads,
+    const string& config_file_name, const std::shared_ptr<output::EventLog>& log, unsigned int num_threads,
     bool track_index_case)
 {
 	// Configuration file.
@@ -38,7 +39,7 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 }
 
 shared_ptr<Simulator> SimulatorBuilder::Build(
-    const ptree& pt_config, const std::shared_ptr<spdlog::logger>& log, unsigned int num_threads, bool track_index_case)
+    const ptree& pt_config, const std::shared_ptr<output::EventLog>& log, unsigned int num_threads, bool track_index_case)
 {
 	SingleSimulationConfig config;
 	config.Parse(pt_config.get_child("run"));
@@ -47,7 +48,7 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 }
 
 shared_ptr<Simulator> SimulatorBuilder::Build(
-    const SingleSimulationConfig& config, const std::shared_ptr<spdlog::logger>& log, unsigned int num_threads)
+    const SingleSimulationConfig& config, const std::shared_ptr<output::EventLog>& log, unsigned int num_threads)
 {
 	// Disease file.
 	ptree pt_disease;
@@ -63,7 +64,7 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 
 shared_ptr<Simulator> SimulatorBuilder::Build(
     const ptree& pt_config, const ptree& pt_disease, const ptree& pt_contact,
-    const std::shared_ptr<spdlog::logger>& log, unsigned int number_of_threads, bool track_index_case)
+    const std::shared_ptr<output::EventLog>& log, unsigned int number_of_threads, bool track_index_case)
 {
 	SingleSimulationConfig config;
 	config.Parse(pt_config.get_child("run"));
@@ -73,7 +74,7 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 
 shared_ptr<Simulator> SimulatorBuilder::Build(
     const SingleSimulationConfig& config, const ptree& pt_disease, const ptree& pt_contact,
-    const std::shared_ptr<spdlog::logger>& log, unsigned int number_of_threads)
+    const std::shared_ptr<output::EventLog>& log, unsigned int number_of_threads)
 {
 	auto sim = make_shared<Simulator>();
 
@@ -92,8 +93,8 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 	// Initialize calendar.
 	sim->m_calendar = make_shared<Calendar>(config.common_config->initial_calendar);
 
-	// Get log level.
-	sim->m_log_level = config.log_config->log_level;
+	// Get log level. Without a log there is nowhere to write contacts and transmissions to.
+	sim->m_log_level = log ? config.log_config->log_level : LogMode::None;
 
 	// Create a random number generator for the simulator.
 	auto rng = std::make_shared<Random>(config.common_config->rng_seed);
@@ -103,16 +104,17 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 	sim->m_population = PopulationBuilder::Build(config, pt_disease, *rng, log);
 
 	// Initialize clusters.
-	InitializeClusters(sim);
+	sim->InitializeClusters();
 
 	// Initialize disease profile.
 	sim->m_disease_profile.Initialize(config, pt_disease);
 
-	// Initialize Rng handlers
+	// Initialize Rng handlers, one per thread. They all draw the same numbers for a given cluster.
 	unsigned int new_seed = (*rng)(numeric_limits<unsigned int>::max());
 	for (size_t i = 0; i < sim->m_num_threads; i++) {
-		sim->m_rng_handler.emplace_back(RngHandler(new_seed, sim->m_num_threads, i));
+		sim->m_rng_handler.emplace_back(RngHandler(new_seed, config.common_config->rng_engine));
 	}
+	sim->m_cluster_scheduler = make_unique<ClusterScheduler>(sim->m_num_threads);
 
 	// Initialize contact profiles.
 	Cluster::AddContactProfile(ClusterType::Household, ContactProfile(ClusterType::Household, pt_contact));
@@ -127,57 +129,9 @@ shared_ptr<Simulator> SimulatorBuilder::Build(
 	return sim;
 }
 
-void SimulatorBuilder::InitializeClusters(shared_ptr<Simulator> sim)
-{
-	// Determine number of clusters.
-	unsigned int max_id_households = 0U;
-	unsigned int max_id_school_clusters = 0U;
-	unsigned int max_id_work_clusters = 0U;
-	unsigned int max_id_primary_community = 0U;
-	unsigned int max_id_secondary_community = 0U;
-	Population& population = *sim->m_population;
-
-	population.serial_for([&](const Person& p, unsigned int) -> void {
-		max_id_households = std::max(max_id_households, p.GetClusterId(ClusterType::Household));
-		max_id_school_clusters = std::max(max_id_school_clusters, p.GetClusterId(ClusterType::School));
-		max_id_work_clusters = std::max(max_id_work_clusters, p.GetClusterId(ClusterType::Work));
-		max_id_primary_community =
-		    std::max(max_id_primary_community, p.GetClusterId(ClusterType::PrimaryCommunity));
-		max_id_secondary_community =
-		    std::max(max_id_secondary_community, p.GetClusterId(ClusterType::SecondaryCommunity));
-	});
-
-	// Keep separate id counter to provide a unique id for every cluster.
-	unsigned int cluster_id = 1;
-
-	for (size_t i = 0; i <= max_id_households; i++) {
-		sim->m_clusters.m_households.emplace_back(Cluster(cluster_id, ClusterType::Household));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_school_clusters; i++) {
-		sim->m_clusters.m_school_clusters.emplace_back(Cluster(cluster_id, ClusterType::School));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_work_clusters; i++) {
-		sim->m_clusters.m_work_clusters.emplace_back(Cluster(cluster_id, ClusterType::Work));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_primary_community; i++) {
-		sim->m_clusters.m_primary_community.emplace_back(Cluster(cluster_id, ClusterType::PrimaryCommunity));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_secondary_community; i++) {
-		sim->m_clusters.m_secondary_community.emplace_back(
-		    Cluster(cluster_id, ClusterType::SecondaryCommunity));
-		cluster_id++;
-	}
-
-	population.serial_for([&](const Person& p, unsigned int) -> void { sim->AddPersonToClusters(p); });
-}
-
 #if USE_HDF5
 shared_ptr<Simulator> SimulatorBuilder::Load(
-    const SingleSimulationConfig& config, const std::shared_ptr<spdlog::logger>& log,
+    const SingleSimulationConfig& config, const std::shared_ptr<output::EventLog>& log,
     const std::string& cpName, const boost::gregorian::date& date, unsigned int num_threads)
 {	
 	// Disease file.
@@ -189,7 +143,9 @@ shared_ptr<Simulator> SimulatorBuilder::Load(
 	InstallDirs::ReadXmlFile(config.common_config->contact_matrix_file_name, InstallDirs::GetDataDir(), pt_contact);
 
 	auto sim = make_shared<Simulator>();
-	sim->cp = std::make_unique<checkpoint::CheckPoint>(cpName);
+	sim->cp = std::make_unique<checkpoint::CheckPoint>(
+	    cpName, config.common_config->checkpoint_compression, config.common_config->checkpoint_deltas,
+	    config.common_config->checkpoint_full_interval);
 	sim->cp->OpenFile();
 	config.common_config->initial_calendar = sim->cp->LoadCalendar(date);
 	sim->cp->CloseFile();
@@ -209,8 +165,8 @@ shared_ptr<Simulator> SimulatorBuilder::Load(
 	// Initialize calendar.
 	sim->m_calendar = make_shared<Calendar>(config.common_config->initial_calendar);
 
-	// Get log level.
-	sim->m_log_level = config.log_config->log_level;
+	// Get log level. Without a log there is nowhere to write contacts and transmissions to.
+	sim->m_log_level = log ? config.log_config->log_level : LogMode::None;
 
 	// Create a random number generator for the simulator.
 	auto rng = std::make_shared<Random>(config.common_config->rng_seed);
@@ -225,11 +181,12 @@ shared_ptr<Simulator> SimulatorBuilder::Load(
 	// Initialize disease profile.
 	sim->m_disease_profile.Initialize(config, pt_disease);
 
-	// Initialize Rng handlers
+	// Initialize Rng handlers, one per thread. They all draw the same numbers for a given cluster.
 	unsigned int new_seed = (*rng)(numeric_limits<unsigned int>::max());
 	for (size_t i = 0; i < sim->m_num_threads; i++) {
-		sim->m_rng_handler.emplace_back(RngHandler(new_seed, sim->m_num_threads, i));
+		sim->m_rng_handler.emplace_back(RngHandler(new_seed, config.common_config->rng_engine));
 	}
+	sim->m_cluster_scheduler = make_unique<ClusterScheduler>(sim->m_num_threads);
 
 	// Initialize contact profiles.
 	Cluster::AddContactProfile(ClusterType::Household, ContactProfile(ClusterType::Household, pt_contact));
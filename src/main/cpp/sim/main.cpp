@@ -5,6 +5,10 @@
 #include <tclap/CmdLine.h>
 #include "util/Signals.h"
 
+#if USE_MPI
+#include <boost/mpi/environment.hpp>
+#endif
+
 using namespace std;
 using namespace stride;
 using namespace TCLAP;
@@ -12,6 +16,11 @@ using namespace TCLAP;
 /// Main program of the stride simulator.
 int main(int argc, char** argv)
 {
+#if USE_MPI
+	// Lets the simulator spread its regions over several processes when it's started with mpirun.
+	boost::mpi::environment env(argc, argv);
+#endif
+
 	// Set up a signal handler.
 	stride::util::setup_segfault_handler();
 	stride::util::setup_interrupt_handler();
@@ -35,6 +44,18 @@ int main(int argc, char** argv)
 		    "i", "interval", "the amount of days between each checkpoint. The first and last are not counted.",
 		    false, -1, "", cmd);
 
+		ValueArg<unsigned int> compression(
+		    "z", "compression", "the deflate level (0-9) of the checkpoints, 0 meaning no compression.", false,
+		    0, "LEVEL", cmd);
+
+		SwitchArg deltas(
+		    "d", "deltas", "store only the changes since the previous checkpoint, except in the first one.",
+		    cmd, false);
+
+		ValueArg<unsigned int> full_interval(
+		    "k", "full-interval", "with deltas, store every k-th checkpoint in full, starting with the first.",
+		    false, 10, "K", cmd);
+
 		cmd.parse(argc, argv);
 
 		// -----------------------------------------------------------------------------------------
@@ -52,7 +73,8 @@ int main(int argc, char** argv)
 		// -----------------------------------------------------------------------------------------
 		run_stride(
 		    index_case_Arg.getValue(), config_file_Arg.getValue(), h5File.getValue(), date.getValue(),
-		    generate_vis_Arg.getValue(), !hdf5.getValue(), interval.getValue());
+		    generate_vis_Arg.getValue(), !hdf5.getValue(), interval.getValue(), compression.getValue(),
+		    deltas.getValue(), full_interval.getValue());
 	} catch (exception& e) {
 
 		exit_status = EXIT_FAILURE;
@@ -1,9 +1,11 @@
 #include "run_stride.h"
 
+#include "core/LogMode.h"
 #include "multiregion/ParallelSimulationManager.h"
 #include "multiregion/SimulationManager.h"
 #include "multiregion/TravelModel.h"
 #include "output/CasesFile.h"
+#include "output/EventLog.h"
 #include "output/PersonFile.h"
 #include "output/SummaryFile.h"
 #include "output/VisualizerFile.h"
@@ -19,13 +21,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
-#include <spdlog/spdlog.h>
 
 #include <cmath>
 #include <iomanip>
 #include <ios>
 #include <iostream>
-#include <limits>
 #include <mutex>
 #include <stdexcept>
 #include <string>
@@ -36,6 +36,14 @@
 using namespace stride::checkpoint;
 #endif
 
+#if USE_MPI
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/environment.hpp>
+#include <boost/serialization/string.hpp>
+#include "multiregion/MpiSimulationManager.h"
+#endif
+
 namespace stride {
 
 using namespace output;
@@ -54,6 +62,9 @@ std::string calendarFile = "";
 #if USE_HDF5
 std::unique_ptr<CheckPoint> cp;
 std::string cpname;
+
+/// Guards the combined checkpoint, which every simulator adds its own checkpoint to when it is done.
+std::mutex cp_mutex;
 #endif
 
 /// Performs an action just before a simulator step is performed.
@@ -70,13 +81,18 @@ void StrideSimulatorResult::BeforeSimulatorStep(Simulator& sim)
 				cpFile = std::to_string(sim.GetConfiguration().GetId()) + "_" + cpname;
 			}
 			sim.CreateCheckPoint(cpFile, calendarFile);
-			sim.SaveCheckPoint(day);
 			sim.WriteAtlas();
+			sim.SaveCheckPoint(day);
 		}
 	}
 #endif
 
 	if (util::INTERRUPT) {
+#if USE_HDF5
+		if (sim.GetConfiguration().common_config->use_checkpoint) {
+			sim.WaitForCheckPoint();
+		}
+#endif
 		exit(-1);
 	}
 }
@@ -91,11 +107,16 @@ void StrideSimulatorResult::AfterSimulatorStep(Simulator& sim)
 		    (day + 1) % sim.GetConfiguration().common_config->checkpoint_interval == 0) {
 			sim.SaveCheckPoint(day);
 		}
+		// The checkpoint has to be complete before it is combined or the program exits.
+		if (sim.IsDone() || util::INTERRUPT) {
+			sim.WaitForCheckPoint();
+		}
 	}
 	if (sim.IsDone() && sim.GetConfiguration().common_config->use_checkpoint && isMultiConfig) {
 
 		unsigned int id = sim.GetConfiguration().GetId();
 		std::string subFile = std::to_string(sim.GetConfiguration().GetId()) + "_" + cpname;
+		lock_guard<mutex> lock(cp_mutex);
 		cp->OpenFile();
 		cp->CombineCheckPoint(id, subFile);
 		cp->CloseFile();
@@ -105,6 +126,8 @@ void StrideSimulatorResult::AfterSimulatorStep(Simulator& sim)
 	run_clock.Stop();
 	auto infected_count = sim.GetPopulation()->get_infected_count();
 	cases.push_back(infected_count);
+	health_counts = pop->get_health_counts();
+	worker_times = sim.GetWorkerTimes();
 
 	if (generate_vis_data && pop->has_atlas()) {
 		visualizer_data.AddDay(pop);
@@ -178,6 +201,24 @@ void run_stride(const MultiSimulationConfig& config)
 	}
 	auto output_prefix = config.log_config->output_prefix;
 
+#if USE_MPI
+	// When several processes share the simulation, every region is simulated by exactly one of them.
+	const bool use_mpi = boost::mpi::environment::initialized() && !boost::mpi::environment::finalized() &&
+			     boost::mpi::communicator().size() > 1;
+	if (use_mpi) {
+		boost::mpi::communicator world;
+#if USE_HDF5
+		if (config.common_config->use_checkpoint) {
+			FATAL_ERROR("Checkpoints can't be written by several processes. Run with --no-hdf5.");
+		}
+#endif
+		// The processes must agree on the names of their output files.
+		boost::mpi::broadcast(world, output_prefix, 0);
+		config.log_config->output_prefix = output_prefix;
+		cout << "Using MPI process:   " << world.rank() << " of " << world.size() << endl;
+	}
+#endif
+
 	cout << "Project output tag:  " << output_prefix << endl << endl;
 
 	// -----------------------------------------------------------------------------------------
@@ -185,22 +226,33 @@ void run_stride(const MultiSimulationConfig& config)
 	// -----------------------------------------------------------------------------------------
 	cout << "Setting for track_index_case:  " << boolalpha << config.common_config->track_index_case << endl;
 
-	// Set the log queue size.
-	spdlog::set_async_mode(1048576);
-
 	// -----------------------------------------------------------------------------------------
 	// Create simulator.
 	// -----------------------------------------------------------------------------------------
 	Stopwatch<> total_clock("total_clock", true);
 	// multiregion::SequentialSimulationManager<StrideSimulatorResult, multiregion::RegionId> sim_manager{
 	//     num_threads};
-	multiregion::ParallelSimulationManager<StrideSimulatorResult, multiregion::RegionId> sim_manager{
-	    config.region_models.size(), num_threads};
+	std::unique_ptr<multiregion::SimulationManager<StrideSimulatorResult, multiregion::RegionId>> sim_manager;
+#if USE_MPI
+	multiregion::MpiSimulationManager<StrideSimulatorResult, multiregion::RegionId>* mpi_manager = nullptr;
+	if (use_mpi) {
+		auto manager =
+		    std::make_unique<multiregion::MpiSimulationManager<StrideSimulatorResult, multiregion::RegionId>>(
+			boost::mpi::communicator(), num_threads);
+		mpi_manager = manager.get();
+		sim_manager = std::move(manager);
+	}
+#endif
+	if (!sim_manager) {
+		sim_manager = std::make_unique<
+		    multiregion::ParallelSimulationManager<StrideSimulatorResult, multiregion::RegionId>>(
+		    config.region_models.size(), num_threads);
+	}
 
 	// Build all the simulations.
 	struct SimulationTuple
 	{
-		std::string log_name;
+		std::shared_ptr<output::EventLog> log;
 		std::string sim_output_prefix;
 		SingleSimulationConfig sim_config;
 		std::shared_ptr<multiregion::SimulationTask<StrideSimulatorResult>> sim_task;
@@ -211,20 +263,26 @@ void run_stride(const MultiSimulationConfig& config)
 	std::vector<SimulationTuple> tasks;
 	for (const auto& single_config : config.GetSingleConfigs()) {
 		multiregion::RegionId region_id = single_config.GetId();
+#if USE_MPI
+		if (mpi_manager && !mpi_manager->IsLocal(region_id)) {
+			// This region is simulated by another process.
+			continue;
+		}
+#endif
 		cout << "Building simulator #" << region_id << endl;
+		Stopwatch<> build_clock("build_clock", true);
 		auto sim_output_prefix = output_prefix + "_sim" + std::to_string(region_id);
 
 		// -----------------------------------------------------------------------------------------
-		// Create logger
-		// Transmissions:     [TRANSMISSION] <infecterID> <infectedID> <clusterID> <day>
-		// General contacts:  [CNT] <person1ID> <person1AGE> <person2AGE>  <at_home> <at_work> <at_school>
-		// <at_other>
+		// Create the event log (participants, and contacts or transmissions), which can be
+		// converted to CSV files with strideevents. The infector doesn't log anything at
+		// LogMode::None, but the survey participants are still written.
 		// -----------------------------------------------------------------------------------------
-		auto log_name = std::string("contact_logger_") + sim_output_prefix;
-		auto file_logger = spdlog::rotating_logger_mt(
-		    log_name, sim_output_prefix + "_logfile", std::numeric_limits<size_t>::max(),
-		    std::numeric_limits<size_t>::max());
-		file_logger->set_pattern("%v"); // Remove meta data from log => time-stamp of logging
+		std::shared_ptr<output::EventLog> log;
+		if (single_config.log_config->log_level != LogMode::None ||
+		    single_config.common_config->number_of_survey_participants > 0) {
+			log = std::make_shared<output::EventLog>(sim_output_prefix + "_events.bin");
+		}
 
 #if USE_HDF5
 		std::string cpfile = cpname;
@@ -238,18 +296,20 @@ void run_stride(const MultiSimulationConfig& config)
 		}
 		if (load) {
 			tasks.push_back(
-			    {log_name, sim_output_prefix, single_config,
-			     sim_manager.LoadSimulation(single_config, file_logger, cpfile, date, region_id)});
+			    {log, sim_output_prefix, single_config,
+			     sim_manager->LoadSimulation(single_config, log, cpfile, date, region_id)});
 		} else {
 			tasks.push_back(
-			    {log_name, sim_output_prefix, single_config,
-			     sim_manager.CreateSimulation(single_config, file_logger, region_id)});
+			    {log, sim_output_prefix, single_config,
+			     sim_manager->CreateSimulation(single_config, log, region_id)});
 		}
 #else
 		tasks.push_back(
-		    {log_name, sim_output_prefix, single_config,
-		     sim_manager.CreateSimulation(single_config, file_logger, region_id)});
+		    {log, sim_output_prefix, single_config,
+		     sim_manager->CreateSimulation(single_config, log, region_id)});
 #endif
+		cout << "Built simulator #" << region_id << " from " << single_config.GetPopulationPath() << " in "
+		     << build_clock.Stop().ToString() << endl;
 	}
 
 #if USE_HDF5
@@ -264,7 +324,7 @@ void run_stride(const MultiSimulationConfig& config)
 	// Run the simulation.
 	// -----------------------------------------------------------------------------------------
 	Stopwatch<> sim_clock("sim_clock", true);
-	sim_manager.WaitAll();
+	sim_manager->WaitAll();
 	sim_clock.Stop();
 
 	// Generate output files for the simulations.
@@ -294,10 +354,24 @@ void run_stride(const MultiSimulationConfig& config)
 
 		cout << endl << endl;
 		cout << "  run_time: " << sim_result.GetRuntimeString() << "  -- total time: " << total_clock.ToString()
-		     << endl
 		     << endl;
+		for (std::size_t i = 0; i < sim_result.worker_times.size(); i++) {
+			const auto& times = sim_result.worker_times[i];
+			cout << "  thread " << setw(3) << i
+			     << ": busy: " << Stopwatch<>::DurationToString(times.busy)
+			     << "  idle: " << Stopwatch<>::DurationToString(times.idle) << "  clusters: " << times.clusters
+			     << "  steals: " << times.steals << endl;
+		}
+		cout << "  health:";
+		for (unsigned int i = 0; i < NumOfHealthStatuses(); i++) {
+			const auto status = static_cast<HealthStatus>(i);
+			cout << "  " << ToString(status) << ": " << sim_result.health_counts.Get(status);
+		}
+		cout << endl << endl;
 
-		spdlog::drop(sim_tuple.log_name);
+		if (sim_tuple.log) {
+			sim_tuple.log->Close();
+		}
 	}
 
 	// -----------------------------------------------------------------------------------------
@@ -316,10 +390,11 @@ void run_stride(const SingleSimulationConfig& config) { run_stride(config.AsMult
 /// Run the stride simulator.
 void run_stride(
     bool track_index_case, const string& config_file_name, const std::string& h5_file, const std::string& date,
-    bool gen_vis, bool checkpoint, unsigned int interval)
+    bool gen_vis, bool checkpoint, unsigned int interval, unsigned int compression, bool deltas,
+    unsigned int full_interval)
 {
 	if (config_file_name.empty() && checkpoint) {
-		run_stride_noConfig(track_index_case, h5_file, date, gen_vis, interval);
+		run_stride_noConfig(track_index_case, h5_file, date, gen_vis, interval, compression, deltas, full_interval);
 		return;
 	}
 	std::string realFile(h5_file);
@@ -339,6 +414,9 @@ void run_stride(
 	config.common_config->generate_vis_file = gen_vis;
 	config.common_config->use_checkpoint = checkpoint;
 	config.common_config->checkpoint_interval = interval;
+	config.common_config->checkpoint_compression = compression;
+	config.common_config->checkpoint_deltas = deltas;
+	config.common_config->checkpoint_full_interval = full_interval;
 
 	if (config.log_config->output_prefix.length() == 0) {
 		config.log_config->output_prefix = TimeStamp().ToTag();
@@ -361,7 +439,8 @@ void run_stride(
 }
 
 void run_stride_noConfig(
-    bool track_index_case, const std::string& h5_file, const std::string& datestr, bool gen_vis, unsigned int interval)
+    bool track_index_case, const std::string& h5_file, const std::string& datestr, bool gen_vis, unsigned int interval,
+    unsigned int compression, bool deltas, unsigned int full_interval)
 {
 #if USE_HDF5
 	load = true;
@@ -412,6 +491,9 @@ void run_stride_noConfig(
 	std::cout<<"Loaded the config"<<std::endl;
 	config.common_config->generate_vis_file = gen_vis;
 	config.common_config->checkpoint_interval = interval;
+	config.common_config->checkpoint_compression = compression;
+	config.common_config->checkpoint_deltas = deltas;
+	config.common_config->checkpoint_full_interval = full_interval;
 
 	run_stride(config);
 
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 #include "core/Cluster.h"
+#include "core/ClusterScheduler.h"
+#include "core/HealthCounts.h"
 #include "multiregion/TravelModel.h"
 #include "output/VisualizerData.h"
 #include "pop/Population.h"
@@ -31,6 +33,12 @@ public:
 	VisualizerData visualizer_data;
 	bool generate_vis_data;
 
+	/// The number of people per health status after the last step.
+	HealthCounts health_counts;
+
+	/// The time spent by each of the simulator's cluster scheduler workers.
+	std::vector<ClusterScheduler::WorkerTimes> worker_times;
+
 	/// Gets the total run-time for this simulator result.
 	util::Stopwatch<>::TDuration GetRuntime() const { return run_clock.Get(); }
 
@@ -67,11 +75,13 @@ void run_stride(const SingleSimulationConfig& config);
 /// Runs the simulator with the given configuration file.
 void run_stride(
     bool track_index_case, const std::string& config_file_name, const std::string& h5_file, const std::string& date,
-    bool gen_vis = false, bool checkpoint = false, unsigned int interval = -1);
+    bool gen_vis = false, bool checkpoint = false, unsigned int interval = -1, unsigned int compression = 0,
+    bool deltas = false, unsigned int full_interval = 10);
 
 /// Runs the simulator if no config file was given. It will try to load the h5_file.
 void run_stride_noConfig(
-    bool track_index_case, const std::string& h5_file, const std::string& date, bool gen_vis, unsigned int interval);
+    bool track_index_case, const std::string& h5_file, const std::string& date, bool gen_vis, unsigned int interval,
+    unsigned int compression = 0, bool deltas = false, unsigned int full_interval = 10);
 
 } // end_of_namespace
 
@@ -0,0 +1,217 @@
+#ifndef PHILOX_H_INCLUDED
+#define PHILOX_H_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace stride {
+namespace util {
+
+/**
+ * The Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3", SC 2011). Every 128-bit output block is a pure function of a
+ * 128-bit counter and a 64-bit key, so independent streams are obtained by fixing part of the
+ * counter, and blocks can be generated in any order or many at a time. Fill generates blocks
+ * in groups, four at a time with SSE2 (which every x86-64 processor supports).
+ */
+class Philox
+{
+public:
+	using Block = std::array<std::uint32_t, 4>;
+	using Key = std::array<std::uint32_t, 2>;
+
+	/// Creates a generator for the given stream of the given seed.
+	Philox(std::uint64_t seed, std::uint64_t stream)
+	    : m_key{{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}}, m_stream(stream),
+	      m_block(0), m_spare(0.0), m_has_spare(false)
+	{
+	}
+
+	/// Computes the output block for the given counter and key.
+	static Block Generate(Block counter, Key key)
+	{
+		for (int round = 0; round < 10; round++) {
+			if (round > 0) {
+				key[0] += g_weyl0;
+				key[1] += g_weyl1;
+			}
+			const std::uint64_t product0 = static_cast<std::uint64_t>(g_multiplier0) * counter[0];
+			const std::uint64_t product1 = static_cast<std::uint64_t>(g_multiplier1) * counter[2];
+			counter = {{static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+				    static_cast<std::uint32_t>(product1),
+				    static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+				    static_cast<std::uint32_t>(product0)}};
+		}
+		return counter;
+	}
+
+	/// Gets a random double from [0, 1[.
+	double NextDouble()
+	{
+		if (m_has_spare) {
+			m_has_spare = false;
+			return m_spare;
+		}
+		const auto block = Generate(NextCounter(), m_key);
+		m_spare = ToDouble(block[2], block[3]);
+		m_has_spare = true;
+		return ToDouble(block[0], block[1]);
+	}
+
+	/// Fills the given buffer with random doubles from [0, 1[. This produces the same numbers
+	/// as calling NextDouble count times.
+	void Fill(double* values, std::size_t count)
+	{
+		std::size_t i = 0;
+		if (m_has_spare && count > 0) {
+			values[i++] = m_spare;
+			m_has_spare = false;
+		}
+
+		// Generate g_lanes blocks (2 * g_lanes doubles) at a time.
+		while (count - i >= 2 * g_lanes) {
+			FillLanes(values + i);
+			i += 2 * g_lanes;
+		}
+		while (i < count) {
+			values[i++] = NextDouble();
+		}
+	}
+
+private:
+	/// The number of blocks that Fill generates at once.
+	static constexpr std::size_t g_lanes = 16;
+
+	/// The round multipliers and the Weyl sequence constants that bump the key.
+	static constexpr std::uint32_t g_multiplier0 = 0xD2511F53;
+	static constexpr std::uint32_t g_multiplier1 = 0xCD9E8D57;
+	static constexpr std::uint32_t g_weyl0 = 0x9E3779B9;
+	static constexpr std::uint32_t g_weyl1 = 0xBB67AE85;
+
+	/// Gets the counter for the next block: the block number, followed by the stream number.
+	Block NextCounter()
+	{
+		const auto block = m_block++;
+		return {{static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+			 static_cast<std::uint32_t>(m_stream), static_cast<std::uint32_t>(m_stream >> 32)}};
+	}
+
+	/// Converts two 32-bit words to a double with 53 random bits.
+	static double ToDouble(std::uint32_t high, std::uint32_t low)
+	{
+		return ((high >> 5) * 67108864.0 + (low >> 6)) * (1.0 / 9007199254740992.0);
+	}
+
+	/// Generates the next g_lanes blocks and stores them as 2 * g_lanes doubles.
+	void FillLanes(double* values)
+	{
+		std::uint32_t c0[g_lanes], c1[g_lanes], c2[g_lanes], c3[g_lanes];
+		for (std::size_t lane = 0; lane < g_lanes; lane++) {
+			const auto block = m_block + lane;
+			c0[lane] = static_cast<std::uint32_t>(block);
+			c1[lane] = static_cast<std::uint32_t>(block >> 32);
+			c2[lane] = static_cast<std::uint32_t>(m_stream);
+			c3[lane] = static_cast<std::uint32_t>(m_stream >> 32);
+		}
+		m_block += g_lanes;
+
+#ifdef __SSE2__
+		// Every register holds the same word of four blocks. SSE2 multiplies the even (or the
+		// odd) words of two registers into two 64-bit products, which are then interleaved again.
+		const __m128i low_words = _mm_set1_epi64x(0xFFFFFFFF);
+		const __m128i high_words = _mm_slli_epi64(low_words, 32);
+		const __m128i multiplier0 = _mm_set1_epi32(static_cast<int>(g_multiplier0));
+		const __m128i multiplier1 = _mm_set1_epi32(static_cast<int>(g_multiplier1));
+		const auto multiply = [&](__m128i words, __m128i multiplier, __m128i& high, __m128i& low) {
+			const __m128i even = _mm_mul_epu32(words, multiplier);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(words, 32), multiplier);
+			high = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, high_words));
+			low = _mm_or_si128(_mm_and_si128(even, low_words), _mm_slli_epi64(odd, 32));
+		};
+
+		// The groups of four blocks are independent, so their rounds are interleaved.
+		static_assert(g_lanes % 4 == 0, "Philox lanes must fill whole SSE2 registers.");
+		constexpr std::size_t groups = g_lanes / 4;
+		__m128i x0[groups], x1[groups], x2[groups], x3[groups];
+		for (std::size_t group = 0; group < groups; group++) {
+			x0[group] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + 4 * group));
+			x1[group] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c1 + 4 * group));
+			x2[group] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c2 + 4 * group));
+			x3[group] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c3 + 4 * group));
+		}
+
+		std::uint32_t k0 = m_key[0];
+		std::uint32_t k1 = m_key[1];
+		for (int round = 0; round < 10; round++) {
+			const __m128i key0 = _mm_set1_epi32(static_cast<int>(k0));
+			const __m128i key1 = _mm_set1_epi32(static_cast<int>(k1));
+			for (std::size_t group = 0; group < groups; group++) {
+				__m128i high0, low0, high1, low1;
+				multiply(x0[group], multiplier0, high0, low0);
+				multiply(x2[group], multiplier1, high1, low1);
+				x0[group] = _mm_xor_si128(_mm_xor_si128(high1, x1[group]), key0);
+				x1[group] = low1;
+				x2[group] = _mm_xor_si128(_mm_xor_si128(high0, x3[group]), key1);
+				x3[group] = low0;
+			}
+			k0 += g_weyl0;
+			k1 += g_weyl1;
+		}
+
+		// Interleave the words such that the doubles come out in the same order as in
+		// NextDouble, and convert them two at a time.
+		const auto convert = [](__m128i high, __m128i low) {
+			return _mm_mul_pd(
+			    _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(high), _mm_set1_pd(67108864.0)), _mm_cvtepi32_pd(low)),
+			    _mm_set1_pd(1.0 / 9007199254740992.0));
+		};
+		for (std::size_t group = 0; group < groups; group++) {
+			const __m128i high_first = _mm_srli_epi32(_mm_unpacklo_epi32(x0[group], x2[group]), 5);
+			const __m128i low_first = _mm_srli_epi32(_mm_unpacklo_epi32(x1[group], x3[group]), 6);
+			const __m128i high_second = _mm_srli_epi32(_mm_unpackhi_epi32(x0[group], x2[group]), 5);
+			const __m128i low_second = _mm_srli_epi32(_mm_unpackhi_epi32(x1[group], x3[group]), 6);
+			double* out = values + 8 * group;
+			_mm_storeu_pd(out, convert(high_first, low_first));
+			_mm_storeu_pd(out + 2, convert(_mm_srli_si128(high_first, 8), _mm_srli_si128(low_first, 8)));
+			_mm_storeu_pd(out + 4, convert(high_second, low_second));
+			_mm_storeu_pd(out + 6, convert(_mm_srli_si128(high_second, 8), _mm_srli_si128(low_second, 8)));
+		}
+#else
+		std::uint32_t k0 = m_key[0];
+		std::uint32_t k1 = m_key[1];
+		for (int round = 0; round < 10; round++) {
+			for (std::size_t lane = 0; lane < g_lanes; lane++) {
+				const std::uint64_t product0 = static_cast<std::uint64_t>(g_multiplier0) * c0[lane];
+				const std::uint64_t product1 = static_cast<std::uint64_t>(g_multiplier1) * c2[lane];
+				c0[lane] = static_cast<std::uint32_t>(product1 >> 32) ^ c1[lane] ^ k0;
+				c1[lane] = static_cast<std::uint32_t>(product1);
+				c2[lane] = static_cast<std::uint32_t>(product0 >> 32) ^ c3[lane] ^ k1;
+				c3[lane] = static_cast<std::uint32_t>(product0);
+			}
+			k0 += g_weyl0;
+			k1 += g_weyl1;
+		}
+
+		for (std::size_t lane = 0; lane < g_lanes; lane++) {
+			values[2 * lane] = ToDouble(c0[lane], c1[lane]);
+			values[2 * lane + 1] = ToDouble(c2[lane], c3[lane]);
+		}
+#endif
+	}
+
+	Key m_key;
+	std::uint64_t m_stream;
+	std::uint64_t m_block;
+	double m_spare;
+	bool m_has_spare;
+};
+
+} // end namespace
+} // end namespace
+
+#endif // include guard
@@ -154,9 +154,11 @@ def main(argv):
         os.remove(output_prefix + '_summary.csv')
         os.remove(output_prefix + '_cases.csv')
 
-        # get participant, contact and transmission files from the 'logfile'.
-        cmd_parse = './lib/log2csv.py ' + output_prefix
-        os.system(cmd_parse)
+        # get participant, contact and transmission files from the event log.
+        if os.path.isfile(output_prefix + '_events.bin'):
+            cmd_parse = './bin/strideevents ' + output_prefix + '_events.bin'
+            os.system(cmd_parse)
+            os.remove(output_prefix + '_events.bin')
 
         # Remove configuration file
         os.remove(output_prefix + '.xml')
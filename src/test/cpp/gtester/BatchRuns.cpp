@@ -7,12 +7,12 @@
 #include <boost/property_tree/ptree.hpp>
 #include <gtest/gtest.h>
 #include <omp.h>
-#include <spdlog/spdlog.h>
 
 #include <cmath>
 #include <map>
 #include <string>
 #include <tuple>
+#include <vector>
 
 using namespace std;
 using namespace stride;
@@ -40,6 +40,45 @@ protected:
 	/// Tearing down the test fixture
 	virtual void TearDown() {}
 
+	/// Gets the configuration of the scenario with the given tag.
+	static boost::property_tree::ptree GetConfig(const string& test_tag)
+	{
+		boost::property_tree::ptree pt_config;
+		pt_config.put("run.rng_seed", g_rng_seed);
+		pt_config.put("run.r0", g_r0);
+		pt_config.put("run.seeding_rate", g_seeding_rate);
+		pt_config.put("run.immunity_rate", g_immunity_rate);
+		pt_config.put("run.population_file", g_population_file);
+		pt_config.put("run.num_days", g_num_days);
+		pt_config.put("run.output_prefix", g_output_prefix);
+		pt_config.put("run.disease_config_file", g_disease_config_file);
+		pt_config.put("run.num_participants_survey", g_num_participants_survey);
+		pt_config.put("run.start_date", g_start_date);
+		pt_config.put("run.holidays_file", g_holidays_file);
+		pt_config.put("run.age_contact_matrix_file", "contact_matrix_average.xml");
+		pt_config.put("run.log_level", "None");
+
+		// Override scenario settings.
+		if (test_tag == "default") {
+			// do nothing
+		}
+		if (test_tag == "seeding_rate") {
+			pt_config.put("run.seeding_rate", g_seeding_rate_adapted);
+		}
+		if (test_tag == "immunity_rate") {
+			pt_config.put("run.seeding_rate", 1 - g_immunity_rate_adapted);
+			pt_config.put("run.immunity_rate", g_immunity_rate_adapted);
+		}
+		if (test_tag == "measles") {
+			pt_config.put("run.disease_config_file", g_disease_config_file_adapted);
+			pt_config.put("run.r0", g_transmission_rate_measles);
+		}
+		if (test_tag == "maximum") {
+			pt_config.put("run.r0", g_transmission_rate_maximum);
+		}
+		return pt_config;
+	}
+
 	// Data members of the test fixture
 	static const string g_population_file;
 	static const double g_r0;
@@ -104,57 +143,14 @@ TEST_P(BatchDemos, Run)
 	// -----------------------------------------------------------------------------------------
 	// Setup configuration.
 	// -----------------------------------------------------------------------------------------
-	boost::property_tree::ptree pt_config;
-	pt_config.put("run.rng_seed", g_rng_seed);
-	pt_config.put("run.r0", g_r0);
-	pt_config.put("run.seeding_rate", g_seeding_rate);
-	pt_config.put("run.immunity_rate", g_immunity_rate);
-	pt_config.put("run.population_file", g_population_file);
-	pt_config.put("run.num_days", g_num_days);
-	pt_config.put("run.output_prefix", g_output_prefix);
-	pt_config.put("run.disease_config_file", g_disease_config_file);
-	pt_config.put("run.num_participants_survey", g_num_participants_survey);
-	pt_config.put("run.start_date", g_start_date);
-	pt_config.put("run.holidays_file", g_holidays_file);
-	pt_config.put("run.age_contact_matrix_file", "contact_matrix_average.xml");
-	pt_config.put("run.log_level", "None");
+	const auto pt_config = GetConfig(test_tag);
 	bool track_index_case = false;
 
-	// -----------------------------------------------------------------------------------------
-	// Override scenario settings.
-	// -----------------------------------------------------------------------------------------
-	if (test_tag == "default") {
-		// do nothing
-	}
-	if (test_tag == "seeding_rate") {
-		pt_config.put("run.seeding_rate", g_seeding_rate_adapted);
-	}
-	if (test_tag == "immunity_rate") {
-		pt_config.put("run.seeding_rate", 1 - g_immunity_rate_adapted);
-		pt_config.put("run.immunity_rate", g_immunity_rate_adapted);
-	}
-	if (test_tag == "measles") {
-		pt_config.put("run.disease_config_file", g_disease_config_file_adapted);
-		pt_config.put("run.r0", g_transmission_rate_measles);
-	}
-	if (test_tag == "maximum") {
-		pt_config.put("run.r0", g_transmission_rate_maximum);
-	}
-
-	// -----------------------------------------------------------------------------------------
-	// Initialize the logger.
-	// -----------------------------------------------------------------------------------------
-	spdlog::set_async_mode(1048576);
-	auto file_logger = spdlog::rotating_logger_mt(
-	    "contact_logger", g_output_prefix + "_logfile", std::numeric_limits<size_t>::max(),
-	    std::numeric_limits<size_t>::max());
-	file_logger->set_pattern("%v"); // Remove meta data from log => time-stamp of logging
-
 	// -----------------------------------------------------------------------------------------
 	// Initialize the simulation.
 	// -----------------------------------------------------------------------------------------
 	cout << "Building the simulator. " << endl;
-	auto sim = SimulatorBuilder::Build(pt_config, file_logger, num_threads, track_index_case);
+	auto sim = SimulatorBuilder::Build(pt_config, nullptr, num_threads, track_index_case);
 	cout << "Done building the simulator. " << endl << endl;
 
 	// -----------------------------------------------------------------------------------------
@@ -165,11 +161,6 @@ TEST_P(BatchDemos, Run)
 		sim->TimeStep(SimulationStepInput());
 	}
 
-	// -----------------------------------------------------------------------------------------
-	// Release and close logger.
-	// -----------------------------------------------------------------------------------------
-	spdlog::drop_all();
-
 	// -----------------------------------------------------------------------------------------
 	// Round up.
 	// -----------------------------------------------------------------------------------------
@@ -179,6 +170,33 @@ TEST_P(BatchDemos, Run)
 	stride::util::parallel::try_set_number_of_threads(old_number_of_threads);
 }
 
+TEST_F(BatchDemos, SameCasesForAnyNumberOfThreads)
+{
+	auto old_number_of_threads = stride::util::parallel::get_number_of_threads();
+	for (const string engine : {"Mrg2", "Philox"}) {
+		auto pt_config = GetConfig("default");
+		pt_config.put("run.rng_engine", engine);
+
+		// The clusters get the same random numbers no matter which thread processes them, so
+		// every day has the same number of cases.
+		vector<unsigned int> expected;
+		for (unsigned int num_threads : {1U, 4U, 8U}) {
+			stride::util::parallel::try_set_number_of_threads(num_threads);
+			auto sim = SimulatorBuilder::Build(pt_config, nullptr, num_threads, false);
+			vector<unsigned int> cases;
+			for (unsigned int i = 0; i < g_num_days; i++) {
+				sim->TimeStep(SimulationStepInput());
+				cases.push_back(sim->GetPopulation()->get_infected_count());
+			}
+			if (expected.empty()) {
+				expected = cases;
+			}
+			EXPECT_EQ(cases, expected) << engine << " with " << num_threads << " threads";
+		}
+	}
+	stride::util::parallel::try_set_number_of_threads(old_number_of_threads);
+}
+
 namespace {
 string scenarios[]{"default", "seeding_rate", "immunity_rate", "measles", "maximum"};
 
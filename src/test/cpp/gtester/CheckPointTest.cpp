@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <boost/filesystem.hpp>
 #include <checkpoint/CheckPoint.h>
 #include <core/ClusterType.h>
 #include <gtest/gtest.h>
+#include <hdf5.h>
+#include <output/EventLog.h>
 #include <pop/Population.h>
 #include <sim/SimulatorBuilder.h>
 #include <stdio.h>
@@ -102,7 +105,8 @@ TEST(CheckPoint, Write_LoadHolidays)
 	EXPECT_EQ(c.GetDay(), 1U);
 }
 
-TEST(CheckPoint, SaveLoadCheckPoint)
+/// Saves a checkpoint with the given compression level, loads it again and compares the result.
+void SaveAndLoadCheckPoint(unsigned int compression)
 {
 	boost::property_tree::ptree pt_config;
 	util::InstallDirs::ReadXmlFile("config/run_test_save.xml", util::InstallDirs::GetRootDir(), pt_config);
@@ -111,17 +115,9 @@ TEST(CheckPoint, SaveLoadCheckPoint)
 	config.Parse(pt_config.get_child("run"));
 	config.common_config->track_index_case = 0;
 
-	std::string sim_output_prefix = "test";
+	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), nullptr);
 
-	auto log_name = std::string("contact_logger_") + sim_output_prefix;
-	auto file_logger = spdlog::rotating_logger_mt(
-	    log_name, sim_output_prefix + "_logfile", std::numeric_limits<size_t>::max(),
-	    std::numeric_limits<size_t>::max());
-	file_logger->set_pattern("%v"); // Remove meta data from log => time-stamp of logging
-
-	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), file_logger);
-
-	stride::checkpoint::CheckPoint* cp = new stride::checkpoint::CheckPoint("SaveCheckPoint.h5");
+	stride::checkpoint::CheckPoint* cp = new stride::checkpoint::CheckPoint("SaveCheckPoint.h5", compression);
 
 	cp->CreateFile();
 	cp->OpenFile();
@@ -260,4 +256,248 @@ TEST(CheckPoint, SaveLoadCheckPoint)
 		EXPECT_EQ(key.second.name, it->second.name);
 	}
 }
+
+TEST(CheckPoint, SaveLoadCheckPoint) { SaveAndLoadCheckPoint(0); }
+
+TEST(CheckPoint, SaveLoadCompressedCheckPoint) { SaveAndLoadCheckPoint(6); }
+
+TEST(CheckPoint, SaveCheckPointInBackground)
+{
+	boost::property_tree::ptree pt_config;
+	util::InstallDirs::ReadXmlFile("config/run_test_save.xml", util::InstallDirs::GetRootDir(), pt_config);
+
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.common_config->track_index_case = 0;
+
+	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), nullptr);
+	sim->CreateCheckPoint("AsyncCheckPoint.h5", "holidays_none.json");
+	sim->WriteAtlas();
+
+	const auto date = sim->GetDate();
+	std::vector<HealthStatus> statuses;
+	sim->GetPopulation()->serial_for(
+	    [&statuses](const Person& p, unsigned int) { statuses.push_back(p.GetHealth().GetHealthStatus()); });
+
+	// The simulator keeps running while the snapshot of the first day is written.
+	sim->SaveCheckPoint(0);
+	for (unsigned int i = 0; i < 5; i++) {
+		sim->TimeStep(multiregion::SimulationStepInput());
+	}
+	sim->WaitForCheckPoint();
+
+	stride::checkpoint::CheckPoint cp("AsyncCheckPoint.h5");
+	Simulator SimRead;
+	cp.OpenFile();
+	EXPECT_EQ(cp.GetLastDate(), date);
+	cp.LoadCheckPoint(date, SimRead);
+	cp.CloseFile();
+
+	std::size_t i = 0;
+	SimRead.GetPopulation()->serial_for([&statuses, &i](const Person& p, unsigned int) {
+		ASSERT_LT(i, statuses.size());
+		EXPECT_EQ(p.GetHealth().GetHealthStatus(), statuses[i++]);
+	});
+	EXPECT_EQ(i, statuses.size());
+	boost::filesystem::remove("AsyncCheckPoint.h5");
+}
+
+TEST(CheckPoint, SaveLoadDeltaCheckPoints)
+{
+	boost::property_tree::ptree pt_config;
+	util::InstallDirs::ReadXmlFile("config/run_test_save.xml", util::InstallDirs::GetRootDir(), pt_config);
+
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.common_config->track_index_case = 0;
+
+	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), nullptr);
+
+	// The same days are written to a checkpoint with deltas (with a full one every third day) and to one without.
+	stride::checkpoint::CheckPoint deltas("DeltaCheckPoint.h5", 0, true, 3);
+	stride::checkpoint::CheckPoint full("FullCheckPoint.h5");
+	for (auto cp : {&deltas, &full}) {
+		cp->CreateFile();
+		cp->OpenFile();
+		cp->WriteAtlas(sim->GetPopulation()->get_atlas());
+		cp->CloseFile();
+	}
+
+	std::vector<std::pair<boost::gregorian::date, std::vector<HealthStatus>>> days;
+	for (unsigned int day = 0; day < 5; day++) {
+		std::vector<HealthStatus> statuses;
+		sim->GetPopulation()->serial_for([&statuses](const Person& p, unsigned int) {
+			statuses.push_back(p.GetHealth().GetHealthStatus());
+		});
+		days.emplace_back(sim->GetDate(), statuses);
+		for (auto cp : {&deltas, &full}) {
+			cp->OpenFile();
+			cp->SaveCheckPoint(*sim, day);
+			cp->CloseFile();
+		}
+		sim->TimeStep(multiregion::SimulationStepInput());
+	}
+	EXPECT_LT(
+	    boost::filesystem::file_size("DeltaCheckPoint.h5"), boost::filesystem::file_size("FullCheckPoint.h5"));
+
+	// Days 0 and 3 are full checkpoints, the others are deltas.
+	hid_t file = H5Fopen("DeltaCheckPoint.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+	for (unsigned int day = 0; day < days.size(); day++) {
+		hid_t group = H5Gopen2(file, boost::gregorian::to_iso_string(days[day].first).c_str(), H5P_DEFAULT);
+		EXPECT_EQ(H5Aexists(group, "previous") > 0, day % 3 != 0) << "day " << day;
+		H5Gclose(group);
+	}
+	H5Fclose(file);
+
+	// Every day is restored from the deltas as it is from the full checkpoints.
+	for (const auto& day : days) {
+		Simulator SimRead;
+		deltas.OpenFile();
+		deltas.LoadCheckPoint(day.first, SimRead);
+		deltas.CloseFile();
+		Simulator FullRead;
+		full.OpenFile();
+		full.LoadCheckPoint(day.first, FullRead);
+		full.CloseFile();
+
+		std::size_t i = 0;
+		SimRead.GetPopulation()->serial_for([&day, &i](const Person& p, unsigned int) {
+			ASSERT_LT(i, day.second.size());
+			EXPECT_EQ(p.GetHealth().GetHealthStatus(), day.second[i++]);
+		});
+		EXPECT_EQ(i, day.second.size());
+
+		const auto& clRead = SimRead.GetClusters();
+		const auto& clFull = FullRead.GetClusters();
+		for (const auto& types :
+		     {std::make_pair(&clRead.m_households, &clFull.m_households),
+		      std::make_pair(&clRead.m_school_clusters, &clFull.m_school_clusters),
+		      std::make_pair(&clRead.m_work_clusters, &clFull.m_work_clusters),
+		      std::make_pair(&clRead.m_primary_community, &clFull.m_primary_community),
+		      std::make_pair(&clRead.m_secondary_community, &clFull.m_secondary_community)}) {
+			ASSERT_EQ(types.first->size(), types.second->size());
+			for (std::size_t c = 0; c < types.first->size(); c++) {
+				EXPECT_EQ((*types.first)[c].GetId(), (*types.second)[c].GetId());
+				EXPECT_EQ((*types.first)[c].GetPeople(), (*types.second)[c].GetPeople());
+			}
+		}
+	}
+	boost::filesystem::remove("DeltaCheckPoint.h5");
+	boost::filesystem::remove("FullCheckPoint.h5");
+}
+
+TEST(CheckPoint, RestoresHealthAndClusters)
+{
+	boost::property_tree::ptree pt_config;
+	util::InstallDirs::ReadXmlFile("config/run_test_save.xml", util::InstallDirs::GetRootDir(), pt_config);
+
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.common_config->track_index_case = 0;
+
+	// Checkpoint a simulation that is well underway, so people are in every stage of the disease.
+	auto log = std::make_shared<output::EventLog>("RestoreCheckPoint_events.bin");
+	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), log);
+	for (unsigned int i = 0; i < 10; i++) {
+		sim->TimeStep(multiregion::SimulationStepInput());
+	}
+	stride::checkpoint::CheckPoint cp("RestoreCheckPoint.h5");
+	cp.CreateFile();
+	cp.OpenFile();
+	cp.WriteAtlas(sim->GetPopulation()->get_atlas());
+	cp.SaveCheckPoint(*sim, 10);
+	cp.CloseFile();
+
+	Simulator SimRead;
+	cp.OpenFile();
+	cp.LoadCheckPoint(sim->GetDate(), SimRead);
+	cp.CloseFile();
+
+	const auto& origPop = *sim->GetPopulation();
+	const auto& popRead = *SimRead.GetPopulation();
+	ASSERT_EQ(origPop.size(), popRead.size());
+	EXPECT_GT(origPop.get_infected_count(), 0U);
+	EXPECT_EQ(origPop.get_infected_count(), popRead.get_infected_count());
+	for (auto orig = origPop.begin(), read = popRead.begin(); orig != origPop.end(); ++orig, ++read) {
+		EXPECT_EQ((*orig).GetHealth().GetHealthStatus(), (*read).GetHealth().GetHealthStatus());
+		EXPECT_EQ(sim->GetDaysInfected(*orig), (*read).GetHealth().GetDaysInfected());
+	}
+
+	// The rebuilt clusters have the same members, although not necessarily in the same order.
+	auto ids = [](const Cluster& cluster) {
+		std::vector<PersonId> result;
+		for (const auto& p : cluster.GetPeople()) {
+			result.push_back(p.GetId());
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+	const auto& clOrig = sim->GetClusters();
+	const auto& clRead = SimRead.GetClusters();
+	for (const auto& types :
+	     {std::make_pair(&clOrig.m_households, &clRead.m_households),
+	      std::make_pair(&clOrig.m_school_clusters, &clRead.m_school_clusters),
+	      std::make_pair(&clOrig.m_work_clusters, &clRead.m_work_clusters),
+	      std::make_pair(&clOrig.m_primary_community, &clRead.m_primary_community),
+	      std::make_pair(&clOrig.m_secondary_community, &clRead.m_secondary_community)}) {
+		ASSERT_EQ(types.first->size(), types.second->size());
+		for (std::size_t c = 0; c < types.first->size(); c++) {
+			EXPECT_EQ((*types.first)[c].GetId(), (*types.second)[c].GetId());
+			EXPECT_EQ(ids((*types.first)[c]), ids((*types.second)[c]));
+		}
+	}
+	boost::filesystem::remove("RestoreCheckPoint.h5");
+	log->Close();
+	boost::filesystem::remove("RestoreCheckPoint_events.bin");
+}
+
+TEST(CheckPoint, WritesVersionAndNoClusters)
+{
+	boost::property_tree::ptree pt_config;
+	util::InstallDirs::ReadXmlFile("config/run_test_save.xml", util::InstallDirs::GetRootDir(), pt_config);
+
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.common_config->track_index_case = 0;
+
+	auto sim = SimulatorBuilder::Build(config.AsSingleConfig(), nullptr);
+	stride::checkpoint::CheckPoint cp("VersionCheckPoint.h5");
+	cp.CreateFile();
+	cp.OpenFile();
+	cp.WriteAtlas(sim->GetPopulation()->get_atlas());
+	cp.SaveCheckPoint(*sim, 0);
+	cp.CloseFile();
+
+	// The date group has a version attribute, and no cluster datasets.
+	const auto groupname = to_iso_string(sim->GetDate());
+	hid_t file = H5Fopen("VersionCheckPoint.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+	hid_t group = H5Gopen2(file, groupname.c_str(), H5P_DEFAULT);
+	for (unsigned int i = 0; i < NumOfClusterTypes(); i++) {
+		EXPECT_LE(H5Lexists(group, ToString(static_cast<ClusterType>(i)).c_str(), H5P_DEFAULT), 0);
+	}
+	ASSERT_GT(H5Aexists(group, "version"), 0);
+	hid_t attr = H5Aopen(group, "version", H5P_DEFAULT);
+	unsigned int version = 0;
+	H5Aread(attr, H5T_NATIVE_UINT, &version);
+	EXPECT_EQ(version, 2U);
+
+	// A checkpoint from a newer version is rejected.
+	version++;
+	H5Awrite(attr, H5T_NATIVE_UINT, &version);
+	H5Aclose(attr);
+	H5Gclose(group);
+	H5Fclose(file);
+
+	Simulator SimRead;
+	cp.OpenFile();
+	EXPECT_THROW(cp.LoadCheckPoint(sim->GetDate(), SimRead), std::runtime_error);
+	cp.CloseFile();
+	boost::filesystem::remove("VersionCheckPoint.h5");
+}
+
+TEST(CheckPoint, RejectsInvalidCompression)
+{
+	EXPECT_THROW(stride::checkpoint::CheckPoint("test.h5", 10), std::runtime_error);
+}
+
 } // Tests
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <gtest/gtest.h>
+#include "core/Cluster.h"
+#include "core/Health.h"
+#include "pop/Population.h"
+#include "util/Random.h"
+
+namespace Tests {
+
+using namespace stride;
+
+namespace {
+
+/// Checks that the given cluster has exactly the given members, partitioned into cases, susceptible and
+/// immune members.
+void ExpectMembers(const Cluster& cluster, std::vector<PersonId> expected_ids)
+{
+	std::vector<PersonId> ids;
+	std::size_t partition = 0;
+	for (const auto& person : cluster.GetPeople()) {
+		ids.push_back(person.GetId());
+		const auto person_partition = Cluster::GetHealthPartition(person.GetHealth());
+		EXPECT_LE(partition, person_partition) << "Person " << person.GetId() << " is in the wrong partition.";
+		partition = person_partition;
+	}
+	std::sort(ids.begin(), ids.end());
+	std::sort(expected_ids.begin(), expected_ids.end());
+	EXPECT_EQ(ids, expected_ids);
+}
+
+} // namespace
+
+TEST(Cluster, AddsAndRemovesMembers)
+{
+	Population population;
+	Cluster cluster(1, ClusterType::Work);
+	std::vector<PersonId> members;
+	for (PersonId id = 0; id < 100; id++) {
+		auto person = population.emplace(id, 30.0, 0U, 0U, 1U, 0U, 0U, disease::Fate());
+		if (id % 3 == 0) {
+			person.GetHealth().SetImmune();
+		} else if (id % 3 == 1) {
+			person.GetHealth().StartInfection();
+		}
+		cluster.AddPerson(person);
+		members.push_back(id);
+	}
+	ExpectMembers(cluster, members);
+
+	// Remove people in a random order, and some people twice.
+	util::Random rng(42);
+	while (!members.empty()) {
+		const auto index = rng(static_cast<unsigned int>(members.size() - 1));
+		const auto person = population.getPerson(members[index]);
+		cluster.RemovePerson(person);
+		cluster.RemovePerson(person);
+		members.erase(members.begin() + index);
+		ASSERT_EQ(cluster.GetSize(), members.size());
+		ExpectMembers(cluster, members);
+	}
+
+	// Removed people can join again.
+	cluster.AddPerson(population.getPerson(3));
+	cluster.AddPerson(population.getPerson(4));
+	ExpectMembers(cluster, {3, 4});
+}
+
+TEST(Cluster, MovesNewCases)
+{
+	Population population;
+	Cluster cluster(1, ClusterType::Work);
+	std::vector<PersonId> members;
+	for (PersonId id = 0; id < 20; id++) {
+		auto person = population.emplace(id, 30.0, 0U, 0U, 1U, 0U, 0U, disease::Fate());
+		if (id >= 15) {
+			person.GetHealth().SetImmune();
+		}
+		cluster.AddPerson(person);
+		members.push_back(id);
+	}
+	EXPECT_EQ(cluster.GetInfectiousCount(), 0u);
+
+	for (PersonId id : {7, 2, 11}) {
+		const auto person = population.getPerson(id);
+		person.GetHealth().StartInfection();
+		cluster.MoveToCases(person);
+		cluster.MoveToCases(person);
+		ExpectMembers(cluster, members);
+	}
+	EXPECT_EQ(cluster.GetInfectiousCount(), 0u);
+}
+
+} // Tests
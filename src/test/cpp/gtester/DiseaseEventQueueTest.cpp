@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <vector>
+#include <gtest/gtest.h>
+#include "core/DiseaseEventQueue.h"
+#include "core/Health.h"
+#include "util/Random.h"
+
+namespace Tests {
+
+using namespace stride;
+
+TEST(DiseaseEventQueue, FollowsDailyUpdates)
+{
+	util::Random rng(2017);
+	const std::size_t count = 200;
+
+	// Every person is infected on a random day. The expected health is updated every day, the other
+	// one only on the days that the queue returns.
+	std::vector<Health> expected;
+	std::vector<Health> actual;
+	std::vector<unsigned int> infection_days;
+	for (std::size_t i = 0; i < count; i++) {
+		disease::Fate fate;
+		fate.start_infectiousness = rng(20);
+		fate.start_symptomatic = rng(20);
+		fate.end_infectiousness = fate.start_infectiousness + rng(40);
+		fate.end_symptomatic = fate.start_symptomatic + rng(40);
+		expected.emplace_back(fate);
+		actual.emplace_back(fate);
+		infection_days.push_back(1 + rng(30));
+	}
+
+	DiseaseEventQueue queue;
+	std::size_t infected = 0;
+	for (unsigned int day = 1; day < 100; day++) {
+		for (std::size_t i = 0; i < count; i++) {
+			expected[i].Update();
+		}
+		for (const auto id : queue.AdvanceDay()) {
+			actual[id].Update(queue.GetDaysBehind(id));
+			queue.Update(id, actual[id]);
+		}
+		infected = 0;
+		for (PersonId id = 0; id < count; id++) {
+			if (infection_days[id] == day) {
+				expected[id].StartInfection();
+				actual[id].StartInfection();
+				queue.Update(id, actual[id]);
+			}
+			ASSERT_EQ(expected[id].GetHealthStatus(), actual[id].GetHealthStatus()) << "Person " << id;
+			if (expected[id].IsInfected()) {
+				infected++;
+				EXPECT_EQ(
+				    expected[id].GetDaysInfected(), actual[id].GetDaysInfected() + queue.GetDaysBehind(id));
+			} else {
+				EXPECT_EQ(queue.GetDaysBehind(id), 0U);
+			}
+		}
+	}
+	EXPECT_EQ(queue.GetSize(), infected);
+}
+
+TEST(DiseaseEventQueue, SkipsRemovedAndRescheduledPeople)
+{
+	disease::Fate fate;
+	fate.start_infectiousness = 2;
+	fate.start_symptomatic = 3;
+	fate.end_infectiousness = 4;
+	fate.end_symptomatic = 5;
+	Health health(fate);
+	health.StartInfection();
+
+	DiseaseEventQueue queue;
+	queue.Update(0, health);
+	queue.Update(1, health);
+	queue.Update(1, health);
+	queue.Update(2, health);
+	queue.Remove(2);
+	EXPECT_EQ(queue.GetSize(), 2U);
+
+	EXPECT_TRUE(queue.AdvanceDay().empty());
+	EXPECT_EQ(queue.AdvanceDay(), std::vector<PersonId>({0, 1}));
+	EXPECT_EQ(queue.GetDaysBehind(0), 2U);
+	EXPECT_EQ(queue.GetDaysBehind(2), 0U);
+}
+
+} // namespace Tests
@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include "core/ClusterType.h"
+#include "output/EventLog.h"
+
+namespace Tests {
+
+using namespace stride;
+using namespace stride::output;
+
+namespace {
+
+/// The event log that is written in these tests.
+const std::string g_log_file = "tmp_test_events.bin";
+
+/// Creates a contact event.
+EventRecord MakeContact(std::uint32_t day, std::uint32_t person_id, std::uint32_t other_id, ClusterType type)
+{
+	return {day, person_id, other_id, 20.0F, 40.5F, EventKind::Contact, static_cast<std::uint8_t>(type), 0, 0};
+}
+
+/// Reads a whole file.
+std::string ReadFile(const std::string& path)
+{
+	std::ifstream file(path);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	return contents.str();
+}
+
+} // namespace
+
+TEST(EventLogTest, MultipleWritersRoundTrip)
+{
+	const unsigned int num_writers = 3;
+	const std::size_t count = 2 * EventLog::g_block_size + 17;
+	{
+		EventLog log(g_log_file);
+		log.ReserveWriters(num_writers);
+		for (std::uint32_t writer = 0; writer < num_writers; writer++) {
+			for (std::uint32_t i = 0; i < count + writer; i++) {
+				log.GetWriter(writer).Append(MakeContact(i % 7, writer, i, ClusterType::Work));
+			}
+			log.Flush();
+		}
+	}
+
+	// Every writer's events must come back, in the order in which they were appended.
+	std::vector<std::uint32_t> next(num_writers, 0);
+	std::size_t num_blocks = 0;
+	EventLogReader reader(g_log_file);
+	std::vector<EventRecord> records;
+	while (reader.ReadBlock(records)) {
+		num_blocks++;
+		EXPECT_LE(records.size(), EventLog::g_block_size);
+		for (const auto& e : records) {
+			ASSERT_LT(e.person_id, num_writers);
+			EXPECT_EQ(e.other_id, next[e.person_id]);
+			EXPECT_EQ(e.day, next[e.person_id] % 7);
+			EXPECT_EQ(e.kind, EventKind::Contact);
+			EXPECT_EQ(e.GetClusterType(), ClusterType::Work);
+			EXPECT_EQ(e.person_age, 20.0F);
+			EXPECT_EQ(e.other_age, 40.5F);
+			next[e.person_id]++;
+		}
+	}
+	for (std::uint32_t writer = 0; writer < num_writers; writer++) {
+		EXPECT_EQ(next[writer], count + writer);
+	}
+	EXPECT_EQ(num_blocks, 3 * num_writers);
+	boost::filesystem::remove(g_log_file);
+}
+
+TEST(EventLogTest, WritesCsvFiles)
+{
+	{
+		EventLog log(g_log_file);
+		log.GetWriter(0).Append({0, 12, 0, 35.0F, 0.0F, EventKind::Participant, 0, 'F', 0});
+		log.GetWriter(0).Append(MakeContact(3, 12, 13, ClusterType::PrimaryCommunity));
+		log.GetWriter(0).Append(
+		    {4, 12, 14, 35.0F, 9.0F, EventKind::Transmission, static_cast<std::uint8_t>(ClusterType::School), 0,
+		     0});
+	}
+	WriteEventCsvFiles(g_log_file, "tmp_test");
+
+	EXPECT_EQ(ReadFile("tmp_test_participants.csv"), "local_id,part_age,part_gender\n12,35,F\n");
+	EXPECT_EQ(
+	    ReadFile("tmp_test_contacts.csv"),
+	    "local_id,part_age,cnt_age,cnt_home,cnt_school,cnt_work,cnt_prim_comm,cnt_sec_comm,sim_day\n"
+	    "12,20,40.5,0,0,0,1,0,3\n");
+	EXPECT_EQ(
+	    ReadFile("tmp_test_transmissions.csv"),
+	    "local_id,new_infected_id,cnt_location,sim_day\n12,14," + ToString(ClusterType::School) + ",4\n");
+
+	for (const auto& file : {"tmp_test_participants.csv", "tmp_test_contacts.csv", "tmp_test_transmissions.csv"}) {
+		boost::filesystem::remove(file);
+	}
+	boost::filesystem::remove(g_log_file);
+}
+
+TEST(EventLogTest, AlwaysWritesParticipantsFile)
+{
+	{
+		EventLog log(g_log_file);
+	}
+	WriteEventCsvFiles(g_log_file, "tmp_test");
+
+	EXPECT_EQ(ReadFile("tmp_test_participants.csv"), "local_id,part_age,part_gender\n");
+	EXPECT_FALSE(boost::filesystem::exists("tmp_test_contacts.csv"));
+	EXPECT_FALSE(boost::filesystem::exists("tmp_test_transmissions.csv"));
+
+	boost::filesystem::remove("tmp_test_participants.csv");
+	boost::filesystem::remove(g_log_file);
+}
+
+TEST(EventLogTest, RejectsInvalidFiles)
+{
+	EXPECT_THROW(EventLogReader("tmp_missing_events.bin"), std::runtime_error);
+
+	std::ofstream(g_log_file) << "this is not an event log";
+	EXPECT_THROW(EventLogReader reader(g_log_file), std::runtime_error);
+	boost::filesystem::remove(g_log_file);
+}
+
+} // namespace Tests
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <geo/GeoIndex.h>
+#include <gtest/gtest.h>
+#include <util/Random.h>
+
+namespace Tests {
+
+using namespace stride;
+using namespace stride::geo;
+
+namespace {
+
+/// Generates random positions in (roughly) Belgium.
+std::vector<GeoPosition> RandomPositions(std::size_t count)
+{
+	util::Random rng(1234);
+	std::vector<GeoPosition> positions;
+	for (std::size_t i = 0; i < count; i++) {
+		positions.push_back({rng(49.5, 51.5), rng(2.5, 6.4)});
+	}
+	return positions;
+}
+
+} // namespace
+
+TEST(GeoIndex, FindInRadiusMatchesLinearScan)
+{
+	const auto positions = RandomPositions(2000);
+	const GeoIndex index(positions);
+	ASSERT_EQ(index.size(), positions.size());
+
+	for (double radius : {0.5, 5.0, 20.0, 80.0, 1000.0}) {
+		for (std::size_t i = 0; i < 50; i++) {
+			const auto& origin = positions[i * 37];
+			std::vector<std::size_t> expected;
+			for (std::size_t j = 0; j < positions.size(); j++) {
+				if (positions[j].Distance(origin) < radius) {
+					expected.push_back(j);
+				}
+			}
+			EXPECT_EQ(index.FindInRadius(origin, radius), expected);
+		}
+	}
+}
+
+TEST(GeoIndex, FindNearestMatchesLinearScan)
+{
+	const auto positions = RandomPositions(2000);
+	const GeoIndex index(positions);
+	const GeoPosition origins[] = {{50.85, 4.35}, {51.22, 4.40}, {49.0, 2.0}, {-33.9, 151.2}};
+
+	for (const auto& origin : origins) {
+		std::vector<std::pair<double, std::size_t>> by_distance;
+		for (std::size_t j = 0; j < positions.size(); j++) {
+			by_distance.emplace_back(positions[j].Distance(origin), j);
+		}
+		std::sort(by_distance.begin(), by_distance.end());
+
+		for (std::size_t k : {1U, 7U, 100U}) {
+			std::vector<std::size_t> expected;
+			for (std::size_t j = 0; j < k; j++) {
+				expected.push_back(by_distance[j].second);
+			}
+			EXPECT_EQ(index.FindNearest(origin, k), expected);
+		}
+	}
+	EXPECT_EQ(index.FindNearest(origins[0], positions.size() + 1).size(), positions.size());
+	EXPECT_TRUE(index.FindNearest(origins[0], 0).empty());
+}
+
+TEST(GeoIndex, FindAcrossAntimeridian)
+{
+	const std::vector<GeoPosition> positions = {{0.0, 179.9}, {0.0, -179.9}, {0.0, 0.0}, {10.0, 179.95}};
+	const GeoIndex index(positions);
+	EXPECT_EQ(index.FindInRadius({0.0, 179.95}, 50.0), (std::vector<std::size_t>{0, 1}));
+	EXPECT_EQ(index.FindNearest({0.0, -179.95}, 2), (std::vector<std::size_t>{1, 0}));
+}
+
+TEST(GeoIndex, EmptyIndex)
+{
+	const GeoIndex index;
+	EXPECT_TRUE(index.FindInRadius({50.0, 4.0}, 100.0).empty());
+	EXPECT_TRUE(index.FindNearest({50.0, 4.0}, 3).empty());
+}
+
+} // Tests
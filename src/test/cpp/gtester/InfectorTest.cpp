@@ -0,0 +1,174 @@
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "core/Cluster.h"
+#include "core/ContactProfile.h"
+#include "core/DiseaseProfile.h"
+#include "core/Health.h"
+#include "core/HealthCounts.h"
+#include "core/Infector.h"
+#include "core/RngHandler.h"
+#include "pop/Population.h"
+
+namespace Tests {
+
+using namespace stride;
+
+namespace {
+
+/// The age of every member of the test clusters.
+const unsigned int g_age = 30;
+
+/// A fate that makes a person infectious one day after they were infected, for a long time.
+const disease::Fate g_fate{1, 100, 100, 100};
+
+/// Infects the given number of members of a cluster (of the given size) in every replicate
+/// and records how many of the others were infected, and how often each of them was infected.
+struct InfectorExperiment
+{
+	InfectorExperiment(std::size_t cluster_size, std::size_t num_infectious, double transmission_probability)
+	    : num_infectious(num_infectious), num_susceptible(cluster_size - num_infectious),
+	      cluster(1, ClusterType::PrimaryCommunity)
+	{
+		// Every infectious member transmits to a given susceptible member with the given probability.
+		ContactProfile profile;
+		profile.fill(0.0);
+		profile[g_age] = -std::log(1.0 - transmission_probability) * cluster_size;
+		Cluster::AddContactProfile(ClusterType::PrimaryCommunity, profile);
+
+		for (PersonId id = 0; id < cluster_size; id++) {
+			cluster.AddPerson(population.emplace(id, g_age, 0, 0, 0, 1, 0, g_fate));
+		}
+	}
+
+	/// Runs the infector on a fresh cluster the given number of times.
+	void Run(std::size_t replicates)
+	{
+		RngHandler rng(1234);
+		infections_per_member.assign(num_susceptible, 0);
+		for (std::size_t i = 0; i < replicates; i++) {
+			// The cluster partitions its members by health, so they rejoin it with their new health.
+			for (PersonId id = 0; id < num_infectious + num_susceptible; id++) {
+				const auto person = population.getPerson(id);
+				cluster.RemovePerson(person);
+				auto& health = person.GetHealth();
+				health = Health(g_fate);
+				if (id < num_infectious) {
+					health.StartInfection();
+					health.Update();
+				}
+				cluster.AddPerson(person);
+			}
+
+			HealthCounts health_changes;
+			std::vector<PersonId> new_cases;
+			Infector<LogMode::None, false, NoLocalInformation>::Execute(
+			    cluster, DiseaseProfile(1.0), rng, health_changes, new_cases, nullptr, nullptr);
+
+			std::size_t infections = 0;
+			for (PersonId id = num_infectious; id < num_infectious + num_susceptible; id++) {
+				if (population.getPerson(id).GetHealth().IsInfected()) {
+					infections++;
+					infections_per_member[id - num_infectious]++;
+				}
+			}
+			EXPECT_EQ(health_changes.Get(HealthStatus::Exposed), static_cast<std::ptrdiff_t>(infections));
+			EXPECT_EQ(health_changes.Get(HealthStatus::Susceptible), -static_cast<std::ptrdiff_t>(infections));
+			EXPECT_EQ(new_cases.size(), infections);
+			infection_counts.push_back(infections);
+		}
+	}
+
+	std::size_t num_infectious;
+	std::size_t num_susceptible;
+	Population population;
+	Cluster cluster;
+	std::vector<std::size_t> infection_counts;
+	std::vector<std::size_t> infections_per_member;
+};
+
+/// Checks that the number of infections in each replicate follows the binomial distribution
+/// B(susceptible, 1 - (1 - p)^infectious), and that no member is favoured over the others.
+void CheckInfections(std::size_t cluster_size, std::size_t num_infectious, double p, std::size_t replicates)
+{
+	InfectorExperiment experiment(cluster_size, num_infectious, p);
+	experiment.Run(replicates);
+
+	const double n = experiment.num_susceptible;
+	const double q = 1.0 - std::pow(1.0 - p, static_cast<double>(num_infectious));
+	const double expected_mean = n * q;
+	const double expected_variance = n * q * (1.0 - q);
+
+	double mean = 0.0;
+	for (auto count : experiment.infection_counts) {
+		mean += count;
+	}
+	mean /= replicates;
+	double variance = 0.0;
+	for (auto count : experiment.infection_counts) {
+		variance += (count - mean) * (count - mean);
+	}
+	variance /= replicates - 1;
+
+	// The sample mean is within five standard errors of the expected mean.
+	EXPECT_NEAR(mean, expected_mean, 5.0 * std::sqrt(expected_variance / replicates));
+
+	// The sample variance is within 25% of the expected variance (for these sample sizes, its
+	// relative standard error is less than 5%).
+	EXPECT_NEAR(variance, expected_variance, 0.25 * expected_variance);
+
+	// Members in the first and second half of the cluster are infected equally often.
+	const std::size_t half = experiment.num_susceptible / 2;
+	double first_half = 0.0;
+	double second_half = 0.0;
+	for (std::size_t i = 0; i < 2 * half; i++) {
+		(i < half ? first_half : second_half) += experiment.infections_per_member[i];
+	}
+	const double expected_half = half * replicates * q;
+	const double half_error = std::sqrt(half * replicates * q * (1.0 - q));
+	EXPECT_NEAR(first_half, expected_half, 5.0 * half_error);
+	EXPECT_NEAR(second_half, expected_half, 5.0 * half_error);
+}
+
+} // namespace
+
+TEST(Infector, SmallClusterMatchesBinomialDistribution)
+{
+	ASSERT_LT(60u, MinSkipSamplingContacts());
+	CheckInfections(60, 5, 0.02, 4000);
+}
+
+TEST(Infector, LargeClusterMatchesBinomialDistribution)
+{
+	ASSERT_GE(1980u, MinSkipSamplingContacts());
+	CheckInfections(2000, 20, 0.002, 1000);
+}
+
+TEST(Infector, LargeClusterHighTransmission)
+{
+	CheckInfections(2000, 20, 0.1, 1000);
+}
+
+TEST(Infector, SkipSamplingIsGeometric)
+{
+	// The number of skipped contacts has mean (1 - p) / p.
+	RngHandler rng(42);
+	const double p = 0.01;
+	const std::size_t samples = 100000;
+	double mean = 0.0;
+	for (std::size_t i = 0; i < samples; i++) {
+		mean += rng.SkipContactsWithoutTransmission(p);
+	}
+	mean /= samples;
+	const double expected_mean = (1.0 - p) / p;
+	const double standard_error = std::sqrt((1.0 - p) / (p * p) / samples);
+	EXPECT_NEAR(mean, expected_mean, 5.0 * standard_error);
+
+	// No transmission means that every contact is skipped.
+	EXPECT_EQ(rng.SkipContactsWithoutTransmission(0.0), std::numeric_limits<std::size_t>::max());
+}
+
+} // Tests
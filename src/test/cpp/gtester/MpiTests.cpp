@@ -1,4 +1,6 @@
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
@@ -6,17 +8,91 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <gtest/gtest.h>
+#include "core/LogMode.h"
+#include "multiregion/MpiSimulationManager.h"
+#include "multiregion/SequentialSimulationManager.h"
 #include "pop/Model.h"
+#include "sim/SimulationConfig.h"
+#include "sim/Simulator.h"
 
 namespace mpi = boost::mpi;
 
+using namespace stride;
+using namespace stride::multiregion;
+
 namespace Tests {
 
+namespace {
+
+/// Gets the MPI environment, which is shared by all tests because MPI can only be initialized once.
+mpi::environment& GetEnvironment()
+{
+	static mpi::environment env;
+	return env;
+}
+
+/// Records the number of infected people after every step.
+class CasesResult final
+{
+public:
+	explicit CasesResult(bool) {}
+
+	void BeforeSimulatorStep(Simulator&) {}
+
+	void AfterSimulatorStep(Simulator& sim) { cases.push_back(sim.GetPopulation()->get_infected_count()); }
+
+	std::vector<unsigned int> cases;
+};
+
+/// Runs every region of the given configuration with the given manager, and returns the tasks.
+std::vector<std::shared_ptr<SimulationTask<CasesResult>>> RunAll(
+    const MultiSimulationConfig& config, SimulationManager<CasesResult>& manager)
+{
+	std::vector<std::shared_ptr<SimulationTask<CasesResult>>> tasks;
+	for (const auto& single_config : config.GetSingleConfigs()) {
+		tasks.push_back(manager.CreateSimulation(single_config, nullptr));
+	}
+	manager.WaitAll();
+	return tasks;
+}
+
+} // namespace
+
 TEST(Mpi, GetEnvironment)
 {
-	mpi::environment env;
+	GetEnvironment();
 	mpi::communicator world;
 	std::cout << "I am process " << world.rank() << " of " << world.size() << "." << std::endl;
 }
 
+TEST(Mpi, MatchesSequentialTravel)
+{
+	GetEnvironment();
+	mpi::communicator world;
+
+	boost::property_tree::ptree pt_config;
+	boost::property_tree::read_xml("../config/run_travel_test.xml", pt_config);
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.log_config->log_level = LogMode::None;
+
+	// Every process simulates its own regions, and checks them against a sequential run of all regions.
+	MpiSimulationManager<CasesResult> mpi_manager(world, 1);
+	const auto mpi_tasks = RunAll(config, mpi_manager);
+	SequentialSimulationManager<CasesResult> sequential_manager(1);
+	const auto sequential_tasks = RunAll(config, sequential_manager);
+
+	ASSERT_EQ(mpi_tasks.size(), sequential_tasks.size());
+	for (std::size_t i = 0; i < mpi_tasks.size(); i++) {
+		if (!mpi_manager.IsLocal(config.GetSingleConfigs()[i].GetId())) {
+			EXPECT_EQ(mpi_tasks[i], nullptr);
+			continue;
+		}
+		ASSERT_NE(mpi_tasks[i], nullptr);
+		const auto mpi_cases = mpi_tasks[i]->GetResult().cases;
+		EXPECT_EQ(mpi_cases.size(), config.common_config->number_of_days);
+		EXPECT_EQ(mpi_cases, sequential_tasks[i]->GetResult().cases);
+	}
+}
+
 } // Tests
@@ -0,0 +1,181 @@
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <gtest/gtest.h>
+#include "core/Health.h"
+#include "core/LogMode.h"
+#include "multiregion/ParallelSimulationManager.h"
+#include "multiregion/SequentialSimulationManager.h"
+#include "multiregion/Visitor.h"
+#include "sim/SimulationConfig.h"
+#include "sim/Simulator.h"
+
+using namespace stride;
+using namespace stride::multiregion;
+
+namespace Tests {
+
+namespace {
+
+/// Records the number of infected people after every step.
+class CasesResult final
+{
+public:
+	explicit CasesResult(bool) {}
+
+	void BeforeSimulatorStep(Simulator&) {}
+
+	void AfterSimulatorStep(Simulator& sim) { cases.push_back(sim.GetPopulation()->get_infected_count()); }
+
+	std::vector<unsigned int> cases;
+};
+
+/// Runs every region of the given configuration with the given manager, and returns the tasks.
+std::vector<std::shared_ptr<SimulationTask<CasesResult>>> RunAll(
+    const MultiSimulationConfig& config, SimulationManager<CasesResult>& manager)
+{
+	std::vector<std::shared_ptr<SimulationTask<CasesResult>>> tasks;
+	for (const auto& single_config : config.GetSingleConfigs()) {
+		tasks.push_back(manager.CreateSimulation(single_config, nullptr));
+	}
+	manager.WaitAll();
+	return tasks;
+}
+
+/// Creates a message with a single visitor, who is identified by the given person id.
+SimulationStepInput MakeMessage(PersonId person_id, RegionId home_region)
+{
+	SimulationStepInput message;
+	message.visitors.emplace_back(person_id, TravellerData(30.0, Health(disease::Fate()), false), home_region, 0);
+	return message;
+}
+
+/// Gets the ids of the visitors in the given message.
+std::vector<PersonId> GetVisitorIds(const SimulationStepInput& message)
+{
+	std::vector<PersonId> ids;
+	for (const auto& visitor : message.visitors) {
+		ids.push_back(visitor.person_id);
+	}
+	return ids;
+}
+
+} // namespace
+
+TEST(ParallelSimulationManager, MatchesSequentialTravel)
+{
+	boost::property_tree::ptree pt_config;
+	boost::property_tree::read_xml("../config/run_travel_test.xml", pt_config);
+	MultiSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	config.log_config->log_level = LogMode::None;
+
+	SequentialSimulationManager<CasesResult> sequential_manager(1);
+	const auto sequential_tasks = RunAll(config, sequential_manager);
+
+	// The regions exchange travellers while they are stepped on several threads at once.
+	for (std::size_t num_task_threads : {1U, 2U, 4U}) {
+		ParallelSimulationManager<CasesResult> parallel_manager(num_task_threads, 1);
+		const auto parallel_tasks = RunAll(config, parallel_manager);
+		ASSERT_EQ(parallel_tasks.size(), sequential_tasks.size());
+		for (std::size_t i = 0; i < parallel_tasks.size(); i++) {
+			const auto parallel_cases = parallel_tasks[i]->GetResult().cases;
+			EXPECT_EQ(parallel_cases.size(), config.common_config->number_of_days);
+			EXPECT_EQ(parallel_cases, sequential_tasks[i]->GetResult().cases)
+			    << "Region " << i << " with " << num_task_threads << " task threads";
+		}
+	}
+}
+
+TEST(ParallelSimulationManager, BufferPullsOnePhaseAtATime)
+{
+	// The task depends on regions 1 and 2.
+	ConcurrentTaskCommunicationBuffer buffer(2);
+	EXPECT_EQ(buffer.GetPhase(), 0U);
+
+	// Region 1 is already a step ahead and sends a message for the next phase before region 2 is done.
+	buffer.Push(0, 2, MakeMessage(20, 2));
+	buffer.Push(0, 1, MakeMessage(10, 1));
+	EXPECT_FALSE(buffer.SatisfyDependency(0));
+	buffer.Push(1, 1, MakeMessage(11, 1));
+	EXPECT_FALSE(buffer.SatisfyDependency(1));
+	EXPECT_FALSE(buffer.SatisfyDependency(0));
+	EXPECT_TRUE(buffer.SatisfyDependency(0));
+
+	// The messages are ordered by region, and the early one is left for the next phase.
+	EXPECT_EQ(GetVisitorIds(buffer.Pull()), std::vector<PersonId>({10, 20}));
+	EXPECT_EQ(buffer.GetPhase(), 1U);
+
+	buffer.Push(1, 2, MakeMessage(21, 2));
+	EXPECT_FALSE(buffer.SatisfyDependency(1));
+	EXPECT_TRUE(buffer.SatisfyDependency(1));
+	EXPECT_EQ(GetVisitorIds(buffer.Pull()), std::vector<PersonId>({11, 21}));
+	EXPECT_EQ(buffer.GetPhase(), 2U);
+
+	// The counters of phase 0 were reset for phase 2, which has no messages.
+	EXPECT_FALSE(buffer.SatisfyDependency(2));
+	EXPECT_FALSE(buffer.SatisfyDependency(2));
+	EXPECT_TRUE(buffer.SatisfyDependency(2));
+	EXPECT_TRUE(buffer.Pull().visitors.empty());
+}
+
+TEST(ParallelSimulationManager, BufferIsReadyOnceWithConcurrentDependencies)
+{
+	const std::size_t num_regions = 8;
+	const std::size_t num_phases = 100;
+	ConcurrentTaskCommunicationBuffer buffer(num_regions - 1);
+
+	// Every region pushes one message and satisfies one dependency per phase. Exactly one of them
+	// makes the task ready, and the task pulls before anyone moves on to the phase after the next.
+	for (std::size_t phase = 0; phase < num_phases; phase++) {
+		std::vector<unsigned int> ready(num_regions, 0);
+		std::vector<std::thread> threads;
+		for (RegionId region = 0; region < num_regions; region++) {
+			threads.emplace_back([&buffer, &ready, phase, region]() {
+				buffer.Push(phase, region, MakeMessage(region, region));
+				ready[region] = buffer.SatisfyDependency(phase);
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		unsigned int ready_count = 0;
+		for (auto r : ready) {
+			ready_count += r;
+		}
+		ASSERT_EQ(ready_count, 1U) << "Phase " << phase;
+		ASSERT_EQ(GetVisitorIds(buffer.Pull()), std::vector<PersonId>({0, 1, 2, 3, 4, 5, 6, 7}));
+	}
+}
+
+TEST(ParallelSimulationManager, ReadyTaskQueue)
+{
+	ReadyTaskQueue queue;
+	queue.Push(3);
+	queue.Push(1);
+	RegionId id = 0;
+	ASSERT_TRUE(queue.Pop(id));
+	EXPECT_EQ(id, 3U);
+	ASSERT_TRUE(queue.Pop(id));
+	EXPECT_EQ(id, 1U);
+
+	// A thread that waits for a task wakes up when one is pushed, and then when the queue is closed.
+	std::vector<RegionId> popped;
+	std::thread consumer([&queue, &popped]() {
+		RegionId ready_id;
+		while (queue.Pop(ready_id)) {
+			popped.push_back(ready_id);
+		}
+	});
+	queue.Push(2);
+	queue.Push(5);
+	queue.Close();
+	consumer.join();
+	EXPECT_EQ(popped, std::vector<RegionId>({2, 5}));
+	EXPECT_FALSE(queue.Pop(id));
+}
+
+} // Tests
@@ -1,10 +1,9 @@
-#include <chrono>
+#include <atomic>
 #include <iostream>
-#include <thread>
 #include <vector>
 #include <gtest/gtest.h>
+#include "core/ClusterScheduler.h"
 #include "util/Parallel.h"
-#include "util/ParallelMap.h"
 #include "util/Random.h"
 
 namespace Tests {
@@ -51,139 +50,46 @@ TEST(Parallel, VectorPseudoParallel)
 	});
 }
 
-template <typename K, typename V>
-using MapActionType = std::function<void(const K& key, V& val, unsigned int thread_number)>;
-
-template <typename K, typename V>
-using MapForType =
-    std::function<void(stride::util::parallel::ParallelMap<K, V>& values, const MapActionType<K, V>& action)>;
-
-void map_test(const MapForType<int, int>& run_for)
+void cluster_scheduler_test(unsigned int num_workers)
 {
-	stride::util::parallel::ParallelMap<int, int> values;
-	for (int i = 0; i < 200; i++) {
-		values[i] = 0;
+	std::vector<stride::Cluster> households;
+	std::vector<stride::Cluster> schools;
+	for (std::size_t i = 0; i < 300; i++) {
+		households.emplace_back(i, stride::ClusterType::Household);
 	}
-	ASSERT_EQ(values.size(), 200u);
-	run_for(values, [](const int& key, int& val, unsigned int) { val = key; });
-	ASSERT_EQ(values.size(), 200u);
-	for (auto pair : values) {
-		ASSERT_EQ(pair.first, pair.second);
+	for (std::size_t i = 300; i < 350; i++) {
+		schools.emplace_back(i, stride::ClusterType::School);
 	}
 
-	stride::util::parallel::ParallelMap<int, int> empty_map;
-	ASSERT_EQ(empty_map.size(), 0u);
-	run_for(empty_map, [](const int& key, int& val, unsigned int) { val = key; });
-	ASSERT_EQ(empty_map.size(), 0u);
+	stride::ClusterScheduler scheduler(num_workers);
+	ASSERT_EQ(scheduler.GetNumberOfWorkers(), num_workers);
 
-	stride::util::parallel::ParallelMap<int, int> sparse_map;
-	sparse_map[100] = 0;
-	for (int i = 1000; i < 1010; i++) {
-		sparse_map[i] = 0;
+	std::vector<std::atomic<unsigned int>> visits(350);
+	for (int pass = 0; pass < 3; pass++) {
+		scheduler.PlanAll({&households, &schools});
+		scheduler.Run([&visits, num_workers](stride::Cluster& cluster, unsigned int worker_id) {
+			ASSERT_LT(worker_id, num_workers);
+			visits[cluster.GetId()]++;
+		});
 	}
-	ASSERT_EQ(sparse_map.size(), 11u);
-	run_for(sparse_map, [](const int& key, int& val, unsigned int) { val++; });
-	ASSERT_EQ(sparse_map.size(), 11u);
-	for (auto pair : sparse_map) {
-		ASSERT_EQ(pair.second, 1) << " (key: " << pair.first << ")";
+	for (const auto& count : visits) {
+		ASSERT_EQ(count.load(), 3u);
 	}
-}
 
-static stride::util::parallel::ParallelMap<int, int> create_perf_test_map(std::size_t size)
-{
-	stride::util::parallel::ParallelMap<int, int> values;
-	for (std::size_t i = 0; i < size; i++) {
-		values[i] = 0;
+	std::size_t clusters = 0;
+	for (const auto& times : scheduler.GetWorkerTimes()) {
+		clusters += times.clusters;
 	}
-	return values;
+	ASSERT_EQ(clusters, 3u * 350u);
 }
 
-static stride::util::parallel::ParallelMap<int, int> perf_test_map1 = create_perf_test_map(100);
-static stride::util::parallel::ParallelMap<int, int> perf_test_map2 = create_perf_test_map(500);
-static stride::util::parallel::ParallelMap<int, int> perf_test_map3 = create_perf_test_map(1000);
+TEST(Parallel, ClusterSchedulerSingleWorker) { cluster_scheduler_test(1); }
 
-void map_perf_test(stride::util::parallel::ParallelMap<int, int>& map, const MapForType<int, int>& run_for)
+TEST(Parallel, ClusterSchedulerParallel)
 {
-	using namespace std::chrono_literals;
-	run_for(map, [](const int& key, int& val, unsigned int) { std::this_thread::sleep_for(1ms); });
+	cluster_scheduler_test(stride::util::parallel::get_number_of_threads());
 }
 
-TEST(Parallel, MapSerial)
-{
-	map_test([](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		stride::util::parallel::serial_for(values, action);
-	});
-}
-
-TEST(Parallel, MapParallel)
-{
-	map_test([](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		stride::util::parallel::parallel_for(values, stride::util::parallel::get_number_of_threads(), action);
-	});
-}
-
-TEST(Parallel, MapPseudoParallel)
-{
-	map_test([](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		stride::util::parallel::parallel_for(values, 1u, action);
-	});
-}
-
-TEST(Parallel, MapPerf1Serial)
-{
-	map_perf_test(
-	    perf_test_map1,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::serial_for(values, action);
-	    });
-}
-
-TEST(Parallel, MapPerf1Parallel)
-{
-	map_perf_test(
-	    perf_test_map1,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::parallel_for(
-			values, stride::util::parallel::get_number_of_threads(), action);
-	    });
-}
-
-TEST(Parallel, MapPerf2Serial)
-{
-	map_perf_test(
-	    perf_test_map2,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::serial_for(values, action);
-	    });
-}
-
-TEST(Parallel, MapPerf2Parallel)
-{
-	map_perf_test(
-	    perf_test_map2,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::parallel_for(
-			values, stride::util::parallel::get_number_of_threads(), action);
-	    });
-}
-
-TEST(Parallel, MapPerf3Serial)
-{
-	map_perf_test(
-	    perf_test_map3,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::serial_for(values, action);
-	    });
-}
-
-TEST(Parallel, MapPerf3Parallel)
-{
-	map_perf_test(
-	    perf_test_map3,
-	    [](stride::util::parallel::ParallelMap<int, int>& values, const MapActionType<int, int>& action) {
-		    stride::util::parallel::parallel_for(
-			values, stride::util::parallel::get_number_of_threads(), action);
-	    });
-}
+TEST(Parallel, ClusterSchedulerManyWorkers) { cluster_scheduler_test(7); }
 
 } // Tests
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <gtest/gtest.h>
+#include "pop/Population.h"
+#include "pop/PopulationFile.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+namespace Tests {
+
+using namespace stride;
+using namespace stride::util;
+
+namespace {
+
+/// The population CSV file that is converted in these tests, and the binary file it's converted to.
+const std::string g_csv_file = "pop_nassau.csv";
+const std::string g_bin_file = "tmp_pop_nassau.bin";
+
+/// Reads the test population from CSV.
+PopulationColumns ReadTestColumns()
+{
+	auto csv = InstallDirs::OpenDataFile(g_csv_file);
+	return PopulationColumns::ReadCsv(*csv);
+}
+
+/// Builds a simulator for the default configuration, with the given population file.
+std::shared_ptr<Simulator> BuildSimulator(const std::string& population_file)
+{
+	boost::property_tree::ptree pt_config;
+	boost::property_tree::read_xml("../config/run_default.xml", pt_config);
+	pt_config.put("run.population_file", population_file);
+	return SimulatorBuilder::Build(pt_config, nullptr, 1, false);
+}
+
+} // namespace
+
+TEST(PopulationFile, BinaryRoundTrip)
+{
+	const auto columns = ReadTestColumns();
+	ASSERT_GT(columns.size(), 0U);
+	BinaryPopulationFile::Write(InstallDirs::GetDataDir() / g_bin_file, columns);
+
+	const BinaryPopulationFile file(InstallDirs::GetDataDir() / g_bin_file);
+	ASSERT_EQ(file.size(), columns.size());
+	for (std::size_t i = 0; i < columns.size(); i++) {
+		EXPECT_EQ(file.GetAges()[i], columns.ages[i]);
+		EXPECT_EQ(file.GetRiskAverseness()[i], columns.risk_averseness[i]);
+		for (unsigned int type = 0; type < NumOfClusterTypes(); type++) {
+			EXPECT_EQ(file.GetClusterIds(static_cast<ClusterType>(type))[i], columns.cluster_ids[type][i]);
+		}
+	}
+}
+
+TEST(PopulationFile, RejectsInvalidFiles)
+{
+	const auto path = InstallDirs::GetDataDir() / "tmp_pop_invalid.bin";
+
+	// Not a population file.
+	{
+		boost::filesystem::ofstream file(path);
+		file << "\"age\",\"household_id\",\"school_id\",\"work_id\",\"primary_community\",\"secondary_community\"\n";
+	}
+	EXPECT_THROW(BinaryPopulationFile{path}, std::runtime_error);
+
+	// Truncated population file.
+	BinaryPopulationFile::Write(path, ReadTestColumns());
+	boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 1);
+	EXPECT_THROW(BinaryPopulationFile{path}, std::runtime_error);
+
+	boost::filesystem::remove(path);
+	EXPECT_THROW(BinaryPopulationFile{path}, std::runtime_error);
+}
+
+TEST(PopulationFile, BinaryBuildsSamePopulationAsCsv)
+{
+	BinaryPopulationFile::Write(InstallDirs::GetDataDir() / g_bin_file, ReadTestColumns());
+	const auto csv_sim = BuildSimulator(g_csv_file);
+	const auto bin_sim = BuildSimulator(g_bin_file);
+	const auto& csv_population = *csv_sim->GetPopulation();
+	const auto& bin_population = *bin_sim->GetPopulation();
+
+	ASSERT_EQ(bin_population.size(), csv_population.size());
+	for (const auto& person : csv_population) {
+		const auto other = bin_population.getPerson(person.GetId());
+		EXPECT_EQ(other.GetAge(), person.GetAge());
+		for (unsigned int type = 0; type < NumOfClusterTypes(); type++) {
+			EXPECT_EQ(other.GetClusterId(static_cast<ClusterType>(type)),
+				  person.GetClusterId(static_cast<ClusterType>(type)));
+		}
+		// The fates are sampled in the same order, from the same random stream.
+		EXPECT_EQ(other.GetHealth().GetHealthStatus(), person.GetHealth().GetHealthStatus());
+		EXPECT_EQ(other.GetHealth().GetStartInfectiousness(), person.GetHealth().GetStartInfectiousness());
+		EXPECT_EQ(other.GetHealth().GetEndInfectiousness(), person.GetHealth().GetEndInfectiousness());
+	}
+}
+
+} // Tests
@@ -4,13 +4,15 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <gtest/gtest.h>
-#include <spdlog/spdlog.h>
 #include "core/Disease.h"
+#include "core/Health.h"
+#include "core/HealthCounts.h"
 #include "core/LogMode.h"
 #include "multiregion/TravelModel.h"
 #include "pop/Generator.h"
 #include "sim/SimulatorBuilder.h"
 #include "util/InstallDirs.h"
+#include "util/Parallel.h"
 
 namespace Tests {
 
@@ -35,11 +37,49 @@ TEST(PopulationGeneration, GeneratedPopulationFitsModel)
 	ASSERT_TRUE(generator->FitsModel(population));
 }
 
+/// Generates a population for the test model with the given seed.
+Population GeneratePopulation(unsigned long seed)
+{
+	ptree pt_config;
+	InstallDirs::ReadXmlFile("../config/run_test_popgen.xml", InstallDirs::GetCurrentDir(), pt_config);
+	stride::SingleSimulationConfig config;
+	config.Parse(pt_config.get_child("run"));
+	ptree pt_disease;
+	InstallDirs::ReadXmlFile(config.common_config->disease_config_file_name, InstallDirs::GetDataDir(), pt_disease);
+	const auto disease = disease::Disease::Parse(pt_disease);
+	stride::util::Random rng(seed);
+
+	auto generator = population::Generator::FromConfig(config, *disease, rng);
+	auto population = generator->Generate();
+	EXPECT_TRUE(generator->FitsModel(population));
+	return population;
+}
+
+TEST(PopulationGeneration, GeneratedPopulationIsDeterministic)
+{
+	const auto num_threads = util::parallel::get_number_of_threads();
+	for (unsigned int threads : {1U, 4U}) {
+		if (!util::parallel::try_set_number_of_threads(threads)) {
+			continue;
+		}
+		const auto first = GeneratePopulation(42);
+		const auto second = GeneratePopulation(42);
+		ASSERT_EQ(first.size(), second.size());
+		for (const auto& person : first) {
+			const auto other = second.getPerson(person.GetId());
+			EXPECT_EQ(person.GetAge(), other.GetAge());
+			for (unsigned int type = 0; type < NumOfClusterTypes(); type++) {
+				EXPECT_EQ(person.GetClusterId(static_cast<ClusterType>(type)),
+					  other.GetClusterId(static_cast<ClusterType>(type)));
+			}
+		}
+	}
+	util::parallel::try_set_number_of_threads(num_threads);
+}
+
 TEST(PopulationGeneration, GeneratedPopulationIsInfectious)
 {
-	auto log = spdlog::stderr_logger_st("test_popgen");
-	log->set_level(spdlog::level::off);
-	auto sim = stride::SimulatorBuilder::Build("../config/run_test_popgen.xml", log, 1, false);
+	auto sim = stride::SimulatorBuilder::Build("../config/run_test_popgen.xml", nullptr, 1, false);
 
 	// Run the simulation for 10 days, and assert an increase in infected persons.
 	unsigned int before = sim->GetPopulation()->get_infected_count();
@@ -47,8 +87,60 @@ TEST(PopulationGeneration, GeneratedPopulationIsInfectious)
 		(void)sim->TimeStep({{}, {}});
 	unsigned int after = sim->GetPopulation()->get_infected_count();
 	ASSERT_GT(after, before);
+}
+
+/// Checks that the population's health counts match a count of everyone's health status.
+void CheckHealthCounts(const Population& population)
+{
+	HealthCounts expected;
+	for (const auto& p : population) {
+		expected.Add(p.GetHealth().GetHealthStatus());
+	}
+	for (unsigned int i = 0; i < NumOfHealthStatuses(); i++) {
+		const auto status = static_cast<HealthStatus>(i);
+		EXPECT_EQ(population.get_health_counts().Get(status), expected.Get(status)) << ToString(status);
+	}
+}
+
+TEST(PopulationGeneration, HealthCountsFollowSimulation)
+{
+	// With several workers, an infection that was counted twice would show up here.
+	for (unsigned int num_threads : {2U, 8U}) {
+		for (bool track_index_case : {false, true}) {
+			auto sim = stride::SimulatorBuilder::Build(
+			    "../config/run_test_popgen.xml", nullptr, num_threads, track_index_case);
+			CheckHealthCounts(*sim->GetPopulation());
+			for (int i = 0; i < 10; i++) {
+				(void)sim->TimeStep({{}, {}});
+				CheckHealthCounts(*sim->GetPopulation());
+			}
+		}
+	}
+}
+
+TEST(PopulationGeneration, HealthCountsFollowTravel)
+{
+	const disease::Fate fate{1, 3, 2, 4};
+	Population population;
+	for (PersonId id = 0; id < 10; id++) {
+		population.emplace(id, 30.0, 1, 0, 0, 0, 0, fate);
+	}
+
+	Health infected(fate);
+	infected.StartInfection();
+	population.getPerson(1).SetHealth(infected);
+	population.getPerson(2).SetHealth(infected);
+	CheckHealthCounts(population);
 
-	spdlog::drop("test_popgen");
+	// People who leave are no longer counted, until they return.
+	population.detach(1);
+	CheckHealthCounts(population);
+	EXPECT_EQ(population.get_infected_count(), 1U);
+	population.reattach(1);
+	EXPECT_EQ(population.get_infected_count(), 2U);
+	population.extract(2);
+	CheckHealthCounts(population);
+	EXPECT_EQ(population.get_infected_count(), 1U);
 }
 
 } // Tests
@@ -0,0 +1,112 @@
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "core/Disease.h"
+#include "pop/Population.h"
+#include "util/Random.h"
+
+namespace Tests {
+
+using namespace stride;
+
+namespace {
+
+/// Creates a population of the given size, in which everyone's household id is their id.
+Population CreatePopulation(unsigned int size)
+{
+	Population population;
+	population.reserve(size);
+	for (unsigned int id = 0; id < size; id++) {
+		population.emplace(id, 30.0, id, 0U, 0U, 0U, 0U, disease::Fate());
+	}
+	return population;
+}
+
+/// Gets the ids of the given people, and checks that they are unique and present.
+std::unordered_set<PersonId> GetUniqueIds(const Population& population, const std::vector<Person>& people)
+{
+	std::unordered_set<PersonId> ids;
+	for (const auto& person : people) {
+		EXPECT_TRUE(ids.insert(person.GetId()).second) << "Person " << person.GetId() << " was picked twice.";
+		EXPECT_EQ(population.getPerson(person.GetId()).GetClusterId(ClusterType::Household), person.GetId());
+	}
+	return ids;
+}
+
+} // namespace
+
+TEST(PopulationSampling, PicksUniquePresentPeople)
+{
+	auto population = CreatePopulation(1000);
+	for (PersonId id = 0; id < 1000; id += 3) {
+		population.detach(id);
+	}
+	population.remove(998);
+	util::Random rng(2017);
+
+	for (std::size_t count : {0U, 1U, 10U, 300U, 600U}) {
+		const auto picks = population.get_random_persons(rng, count);
+		const auto ids = GetUniqueIds(population, picks);
+		EXPECT_EQ(ids.size(), count);
+		for (auto id : ids) {
+			EXPECT_NE(id % 3, 0U);
+			EXPECT_NE(id, 998U);
+		}
+	}
+	EXPECT_EQ(population.get_random_persons(rng, population.size()).size(), population.size());
+	EXPECT_THROW(population.get_random_persons(rng, population.size() + 1), std::runtime_error);
+}
+
+TEST(PopulationSampling, CanPickEveryone)
+{
+	const unsigned int size = 10;
+	auto population = CreatePopulation(size);
+	util::Random rng(2017);
+	const auto everyone = [](const Person&) { return true; };
+	const auto last_two = [](const Person& p) { return p.GetClusterId(ClusterType::Household) >= size - 2; };
+
+	// Draws single people, the complement of a single person, and matches that can only be found by
+	// scanning the population: each of them must be able to yield every present person.
+	std::unordered_set<PersonId> single_ids, many_ids, predicate_ids, scanned_ids;
+	for (unsigned int i = 0; i < 200; i++) {
+		for (const auto& p : population.get_random_persons(rng, 1)) {
+			single_ids.insert(p.GetId());
+		}
+		const auto many = population.get_random_persons(rng, size - 1);
+		many_ids.insert(many.back().GetId());
+		for (const auto& p : population.get_random_persons(rng, 1, everyone)) {
+			predicate_ids.insert(p.GetId());
+		}
+		const auto scanned = population.get_random_persons(rng, 2, last_two);
+		scanned_ids.insert(scanned.back().GetId());
+	}
+	EXPECT_EQ(single_ids.size(), size);
+	EXPECT_EQ(many_ids.size(), size);
+	EXPECT_EQ(predicate_ids.size(), size);
+	EXPECT_EQ(scanned_ids, std::unordered_set<PersonId>({size - 2, size - 1}));
+}
+
+TEST(PopulationSampling, PicksPeopleWhoMatchPredicate)
+{
+	auto population = CreatePopulation(1000);
+	util::Random rng(2017);
+
+	// Many matches are found by drawing random people, few matches by scanning the population.
+	for (unsigned int modulus : {2U, 500U}) {
+		const auto matches = [modulus](const Person& p) {
+			return p.GetClusterId(ClusterType::Household) % modulus == 0;
+		};
+		const auto count = 1000 / modulus;
+		const auto picks = population.get_random_persons(rng, count, matches);
+		const auto ids = GetUniqueIds(population, picks);
+		EXPECT_EQ(ids.size(), count);
+		for (const auto& person : picks) {
+			EXPECT_TRUE(matches(person));
+		}
+		EXPECT_THROW(population.get_random_persons(rng, count + 1, matches), std::runtime_error);
+	}
+}
+
+} // Tests
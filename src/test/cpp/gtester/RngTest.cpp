@@ -0,0 +1,169 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "core/ClusterType.h"
+#include "core/RngEngine.h"
+#include "core/RngHandler.h"
+#include "util/Philox.h"
+
+namespace Tests {
+
+using namespace stride;
+
+namespace {
+
+/// The number of random numbers that the throughput benchmark draws per engine and mode.
+const std::size_t g_perf_count = 1U << 24;
+
+/// The size of the batches that the batched benchmark draws.
+const std::size_t g_perf_batch = 64;
+
+/// Checks that a batch holds the same numbers as consecutive scalar draws.
+void CheckBatchMatchesScalar(RngEngine engine)
+{
+	RngHandler scalar(1234, engine);
+	RngHandler batched(1234, engine);
+	scalar.SetStream(3, ClusterType::School, 2);
+	batched.SetStream(3, ClusterType::School, 2);
+	// Odd and even batch sizes, so Philox has to split its blocks across batches.
+	for (std::size_t count : {1U, 7U, 16U, 33U, 100U, 3U}) {
+		const double* values = batched.NextDoubles(count);
+		for (std::size_t i = 0; i < count; i++) {
+			EXPECT_EQ(values[i], scalar.NextDouble());
+		}
+	}
+}
+
+/// Checks that the numbers are uniformly distributed on [0, 1[.
+void CheckUniform(RngEngine engine)
+{
+	RngHandler rng(42, engine);
+	const std::size_t count = 100000;
+	const std::size_t bins = 10;
+	std::vector<std::size_t> histogram(bins, 0);
+	const double* values = rng.NextDoubles(count);
+	for (std::size_t i = 0; i < count; i++) {
+		ASSERT_GE(values[i], 0.0);
+		ASSERT_LT(values[i], 1.0);
+		histogram[static_cast<std::size_t>(values[i] * bins)]++;
+	}
+	// Every bin count is within five standard deviations of its expected value.
+	for (auto bin : histogram) {
+		EXPECT_NEAR(bin, count / bins, 5.0 * std::sqrt(count * 0.1 * 0.9));
+	}
+}
+
+/// Draws g_perf_count numbers one at a time and returns their sum.
+double PerfScalar(RngEngine engine)
+{
+	RngHandler rng(42, engine);
+	double sum = 0.0;
+	for (std::size_t i = 0; i < g_perf_count; i++) {
+		sum += rng.NextDouble();
+	}
+	return sum;
+}
+
+/// Draws g_perf_count numbers in batches and returns their sum.
+double PerfBatched(RngEngine engine)
+{
+	RngHandler rng(42, engine);
+	double sum = 0.0;
+	for (std::size_t i = 0; i < g_perf_count; i += g_perf_batch) {
+		const double* values = rng.NextDoubles(g_perf_batch);
+		for (std::size_t j = 0; j < g_perf_batch; j++) {
+			sum += values[j];
+		}
+	}
+	return sum;
+}
+
+/// Checks that a cluster's stream doesn't depend on what the handler drew before, and that the
+/// streams of other clusters and days differ from it.
+void CheckClusterStreams(RngEngine engine)
+{
+	RngHandler fresh(1234, engine);
+	RngHandler used(1234, engine);
+	used.SetStream(4, ClusterType::Work, 7);
+	used.NextDoubles(100);
+	fresh.SetStream(5, ClusterType::Household, 7);
+	used.SetStream(5, ClusterType::Household, 7);
+
+	RngHandler other_cluster(1234, engine);
+	other_cluster.SetStream(5, ClusterType::Household, 8);
+	RngHandler other_type(1234, engine);
+	other_type.SetStream(5, ClusterType::School, 7);
+	RngHandler other_day(1234, engine);
+	other_day.SetStream(6, ClusterType::Household, 7);
+
+	std::size_t equal = 0;
+	for (std::size_t i = 0; i < 1000; i++) {
+		const double value = fresh.NextDouble();
+		EXPECT_EQ(value, used.NextDouble());
+		equal += value == other_cluster.NextDouble();
+		equal += value == other_type.NextDouble();
+		equal += value == other_day.NextDouble();
+	}
+	EXPECT_EQ(equal, 0U);
+}
+
+} // namespace
+
+TEST(Rng, PhiloxKnownAnswers)
+{
+	// The known-answer tests from the Random123 distribution.
+	using Block = util::Philox::Block;
+	EXPECT_EQ(util::Philox::Generate({{0, 0, 0, 0}}, {{0, 0}}),
+		  (Block{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+	EXPECT_EQ(util::Philox::Generate({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, {{0xffffffff, 0xffffffff}}),
+		  (Block{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+	EXPECT_EQ(util::Philox::Generate({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, {{0xa4093822, 0x299f31d0}}),
+		  (Block{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+}
+
+TEST(Rng, PhiloxStreamsDiffer)
+{
+	RngHandler first(1234, RngEngine::Philox);
+	RngHandler second(1234, RngEngine::Philox);
+	first.SetStream(3, ClusterType::School, 2);
+	second.SetStream(3, ClusterType::School, 3);
+	std::size_t equal = 0;
+	for (std::size_t i = 0; i < 1000; i++) {
+		equal += first.NextDouble() == second.NextDouble();
+	}
+	EXPECT_EQ(equal, 0U);
+}
+
+TEST(Rng, Mrg2ClusterStreams) { CheckClusterStreams(RngEngine::Mrg2); }
+
+TEST(Rng, PhiloxClusterStreams) { CheckClusterStreams(RngEngine::Philox); }
+
+TEST(Rng, Mrg2BatchMatchesScalar) { CheckBatchMatchesScalar(RngEngine::Mrg2); }
+
+TEST(Rng, PhiloxBatchMatchesScalar) { CheckBatchMatchesScalar(RngEngine::Philox); }
+
+TEST(Rng, Mrg2Uniform) { CheckUniform(RngEngine::Mrg2); }
+
+TEST(Rng, PhiloxUniform) { CheckUniform(RngEngine::Philox); }
+
+// A benchmark rather than a test, so it only runs when asked for, e.g. with
+// --gtest_also_run_disabled_tests --gtest_filter=Rng.DISABLED_Throughput
+TEST(Rng, DISABLED_Throughput)
+{
+	for (auto engine : {RngEngine::Mrg2, RngEngine::Philox}) {
+		for (bool batched : {false, true}) {
+			const auto start = std::chrono::steady_clock::now();
+			const double sum = batched ? PerfBatched(engine) : PerfScalar(engine);
+			const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+			EXPECT_NEAR(sum / g_perf_count, 0.5, 0.01);
+			std::cout << ToString(engine) << (batched ? " batched: " : " scalar: ")
+				  << g_perf_count / seconds.count() / 1e6 << " million draws per second" << std::endl;
+		}
+	}
+}
+
+} // Tests